@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "mapping/parser.hpp"
 #include "mapping/arch-properties.hpp"
 #include "mapping/constraints.hpp"
@@ -5,6 +7,7 @@
 #include "model/sparse-optimization-parser.hpp"
 #include "mapping/fused-mapping.hpp"
 #include "loop-analysis/isl-ir.hpp"
+#include "isl-wrapper/piecewise-polynomial.hpp"
 
 //--------------------------------------------//
 //                Application                 //
@@ -18,35 +21,47 @@ class LooptreeModel
  public:
   struct Result
   {
+    // Each count keeps the dims of its domain, the pw_qpolynomial rendered as
+    // text, and a context-free copy that can be evaluated numerically at
+    // many parameter points without re-running the analysis.
+    using Count = std::tuple<std::vector<analysis::SpaceTime>,
+                             std::string,
+                             isl::PiecewisePolynomial>;
+
     std::map<
       problem::EinsumId,
-      std::tuple<std::vector<analysis::SpaceTime>, std::string>
+      Count
     > ops;
 
     std::map<
       std::tuple<mapping::BufferId, problem::DataSpaceId, mapping::NodeID>,
-      std::tuple<std::vector<analysis::SpaceTime>, std::string>
+      Count
     > fills;
 
     std::map<
       std::tuple<mapping::BufferId, problem::DataSpaceId, mapping::NodeID>,
-      std::tuple<std::vector<analysis::SpaceTime>, std::string>
+      Count
     > reads_to_parent;
 
     std::map<
       std::tuple<mapping::BufferId, problem::DataSpaceId, mapping::NodeID>,
-      std::tuple<std::vector<analysis::SpaceTime>, std::string>
+      Count
     > reads_to_peer;
 
     std::map<
       std::tuple<mapping::BufferId, problem::DataSpaceId, mapping::NodeID>,
-      std::tuple<std::vector<analysis::SpaceTime>, std::string>
+      Count
     > occupancy;
 
     std::map<
       problem::EinsumId,
-      std::tuple<std::vector<analysis::SpaceTime>, std::string>
+      Count
     > temporal_steps;
+
+    // How many of the counts above were computed in closed form (box-shaped
+    // relations) and how many needed barvinok.
+    size_t n_closed_form_counts = 0;
+    size_t n_barvinok_counts = 0;
   };
 
  protected:
@@ -68,6 +83,15 @@ class LooptreeModel
 
   // Run the evaluation.
   Result Run();
+
+  // Evaluate many mappings of the same problem on a pool of worker threads.
+  // Each worker owns its ISL context, so every job re-parses the workload
+  // and its mapping in that context. Results are returned in input order.
+  static std::vector<Result> RunBatch(
+    config::CompoundConfigNode problem,
+    const std::vector<config::CompoundConfigNode>& mappings,
+    unsigned num_threads = std::thread::hardware_concurrency()
+  );
 };
 
 } // namespace application
\ No newline at end of file
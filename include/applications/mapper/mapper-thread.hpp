@@ -111,6 +111,7 @@ class MapperThread
   bool live_status_;
   bool diagnostics_on_;
   bool penalize_consecutive_bypass_fails_;
+  bool branch_and_bound_;
   std::vector<std::string> optimization_metrics_;
   model::Engine::Specs arch_specs_;
   problem::Workload &workload_;
@@ -147,6 +148,7 @@ class MapperThread
     bool live_status,
     bool diagnostics_on,
     bool penalize_consecutive_bypass_fails,
+    bool branch_and_bound,
     std::vector<std::string> optimization_metrics,
     model::Engine::Specs arch_specs,
     problem::Workload &workload,
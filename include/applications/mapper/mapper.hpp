@@ -67,6 +67,7 @@ class Mapper
     std::string stats_string;
     std::string tensella_string;
     std::string xml_mapping_stats_string;
+    std::string columnar_stats_string;
     std::string orojenesis_string;
   };
 
@@ -100,9 +101,14 @@ class Mapper
   bool live_status_;
   bool diagnostics_on_;
   bool penalize_consecutive_bypass_fails_;
+  bool branch_and_bound_;
   bool emit_whoop_nest_;
   std::string out_prefix_;
 
+  // Stats output formats (mapper.stats_format: xml, columnar or both).
+  bool xml_stats_ = true;
+  bool columnar_stats_ = false;
+
   std::vector<std::string> optimization_metrics_;
 
   char* cfg_string_;
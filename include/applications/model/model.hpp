@@ -63,6 +63,7 @@ class Model
     std::string stats_string;
     std::string map_string;
     std::string xml_map_and_stats_string;
+    std::string columnar_stats_string;
     std::string tensella_string;
   };
 
@@ -79,8 +80,9 @@ class Model
   layout::Layouts layout_; 
   bool layout_initialized_ = false;
     
-  // The mapping.
-  Mapping* mapping_;
+  // The mapping. Optional when the model is only used to evaluate
+  // mappings given through ParseMapping().
+  Mapping* mapping_ = nullptr;
 
   // Abstract representation of the architecture.
   ArchProperties* arch_props_;
@@ -93,6 +95,10 @@ class Model
   bool auto_bypass_on_failure_ = false;
   std::string out_prefix_;
 
+  // Stats output formats (model.stats_format: xml, columnar or both).
+  bool xml_stats_ = true;
+  bool columnar_stats_ = false;
+
   // Sparse optimization
   sparse::SparseOptimizationInfo* sparse_optimizations_;
 
@@ -117,6 +123,22 @@ class Model
 
   // Run the evaluation.
   Stats Run();
+
+  // Evaluate many mappings against the parsed problem and architecture,
+  // in parallel with one engine per thread. Results are written to `out` as
+  // CSV rows in mapping order, each as soon as it and all earlier ones are
+  // done.
+  void RunBatch(const std::vector<config::CompoundConfigNode>& mapping_configs,
+                unsigned num_threads, std::ostream& out);
+
+  // Support for evaluating many mappings against the parsed problem and
+  // architecture (server and batch modes). Each thread evaluating in
+  // parallel needs its own engine from SpecEngine().
+  bool ParseMapping(config::CompoundConfigNode mapping_config, Mapping& mapping,
+                    std::string& fail_reason);
+  void SpecEngine(model::Engine& engine) const;
+  const model::Engine::Specs& GetArchSpecs() const { return arch_specs_; }
+  std::vector<model::EvalStatus> Evaluate(Mapping& mapping, model::Engine& engine);
 };
 
 
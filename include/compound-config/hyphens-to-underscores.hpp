@@ -49,6 +49,9 @@ namespace hyphens2underscores
     "arch_space_files",
     "log_orojenesis_mappings",
     "penalize_consecutive_bypass_fails",
+    "branch_and_bound",
+    "prune_index_factorizations",
+    "expand_permutations",
     "emit_whoop_nest",
     "condition_on",
     "energy_per_hop",
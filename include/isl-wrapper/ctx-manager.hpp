@@ -1,8 +1,94 @@
 #pragma once
 
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
+#include <queue>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 #include <isl/cpp.h>
 
+/**
+ * @brief Returns the ISL context of the calling thread, allocating it on
+ *        first use. ISL objects must only be combined with objects from the
+ *        same context, i.e., created on the same thread.
+ */
 isl::ctx& GetIslCtx();
 
 std::mutex& GetIslMutex();
+
+/**
+ * @brief Frees the calling thread's context and allocates a fresh one on the
+ *        next GetIslCtx(). Bounds the memory a long-lived thread accumulates
+ *        in ISL caches. Every object created in the old context must already
+ *        have been destroyed.
+ */
+void ResetIslCtx();
+
+/**
+ * @brief Frees the calling thread's context without allocating a new one.
+ */
+void ReleaseIslCtx();
+
+/**
+ * @brief Copies an ISL object into another context through its textual
+ *        form. Use this (or re-parse from the original spec) to move data
+ *        between threads; ISL objects themselves must never be shared.
+ */
+template<typename IslObj>
+IslObj MigrateIslObj(const IslObj& obj, isl::ctx ctx)
+{
+  std::ostringstream ss;
+  ss << obj;
+  return IslObj(ctx, ss.str());
+}
+
+/**
+ * @brief A fixed-size pool of worker threads, each of which owns a private
+ *        ISL context.
+ *
+ * A worker's context is reset after every `jobs_per_reset` jobs, so a job
+ * must not return ISL objects; it should return ctx-independent results
+ * (numbers, strings, tags). Jobs that need ISL inputs should rebuild them
+ * inside the job, e.g., by re-parsing the workload or via MigrateIslObj().
+ */
+class IslCtxPool
+{
+ public:
+  IslCtxPool(unsigned num_workers = std::thread::hardware_concurrency(),
+             unsigned jobs_per_reset = 1);
+  ~IslCtxPool();
+
+  IslCtxPool(const IslCtxPool&) = delete;
+  IslCtxPool& operator=(const IslCtxPool&) = delete;
+
+  unsigned NumWorkers() const { return workers_.size(); }
+
+  template<typename Job>
+  auto Submit(Job&& job) -> std::future<decltype(job())>
+  {
+    using ReturnType = decltype(job());
+    auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Job>(job));
+    auto future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.emplace([task]() { (*task)(); });
+    }
+    cv_.notify_one();
+    return future;
+  }
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> jobs_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+  unsigned jobs_per_reset_;
+};
@@ -81,6 +81,23 @@ isl_pw_qpolynomial* set_card(set set);
 
 isl_pw_qpolynomial* sum_map_range_card(map map);
 
+/**
+ * @brief Number of range points of each domain point of map.
+ *
+ * Rectangular tilings map every domain point to a box of constant size at an
+ * offset affine in the domain. Such maps are counted directly as the product
+ * of the box sizes; anything else falls back to barvinok's isl_map_card.
+ * If `closed_form` is given, it is set to whether the fast path was taken.
+ */
+__isl_give isl_pw_qpolynomial*
+map_card(__isl_take isl_map* p_map, bool* closed_form = nullptr);
+
+/**
+ * @brief Returns the closed-form count of a box-shaped map, or nullptr if
+ *        map is not box-shaped.
+ */
+__isl_give isl_pw_qpolynomial* box_map_card(__isl_keep isl_map* p_map);
+
 double val_to_double(isl_val* val);
 
 isl_val* get_val_from_singular(__isl_take isl_pw_qpolynomial* pw_qp);
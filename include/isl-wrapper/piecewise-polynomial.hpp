@@ -0,0 +1,86 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <isl/polynomial.h>
+
+namespace isl {
+
+/**
+ * @brief A context-free copy of an isl_pw_qpolynomial for fast evaluation.
+ *
+ * Evaluating an isl_pw_qpolynomial through ISL allocates points and values in
+ * the context that produced it. This IR keeps only integers, so it can be
+ * evaluated at many parameter points (tile sizes, problem dims) without ISL
+ * and outlives the context, e.g., when returned from an IslCtxPool job.
+ *
+ * Variables are ordered as [params..., dims..., locals...], where locals are
+ * the floor divisions of the piece, each defined over the variables before it.
+ */
+class PiecewisePolynomial
+{
+ public:
+  struct Affine
+  {
+    std::vector<long> coefs;
+    long constant = 0;
+
+    long Eval(const std::vector<long>& vars) const;
+  };
+
+  // floor(expr / denom)
+  struct Div
+  {
+    Affine expr;
+    long denom = 1;
+  };
+
+  // expr == 0 if equality, expr >= 0 otherwise. Constraints of a basic set
+  // refer to the locals of that basic set.
+  struct BasicSet
+  {
+    std::vector<Div> divs;
+    std::vector<Affine> eqs;
+    std::vector<Affine> ineqs;
+  };
+
+  // Integer coefficients scaled by the common denominator of the polynomial.
+  struct Term
+  {
+    long coef;
+    std::vector<unsigned> exps;
+  };
+
+  struct Piece
+  {
+    std::vector<BasicSet> domain;
+    std::vector<Div> divs;
+    std::vector<Term> terms;
+    long denom = 1;
+  };
+
+ public:
+  PiecewisePolynomial() = default;
+  PiecewisePolynomial(__isl_keep isl_pw_qpolynomial* p_pwqp);
+
+  const std::vector<std::string>& ParamNames() const { return param_names_; }
+  size_t NumParams() const { return param_names_.size(); }
+  size_t NumDims() const { return n_dims_; }
+
+  // Value at the given parameters and domain point; zero outside the domain.
+  double Evaluate(const std::vector<long>& params,
+                  const std::vector<long>& dims = {}) const;
+
+  // Same, with parameters given by name, e.g., from SymbolicBoundValues().
+  double EvaluateNamed(const std::map<std::string, long>& params,
+                       const std::vector<long>& dims = {}) const;
+
+ private:
+  std::vector<std::string> param_names_;
+  size_t n_dims_ = 0;
+  std::vector<Piece> pieces_;
+};
+
+};  // namespace isl
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include "mapping/loop.hpp"
 #include "workload/shape-models/problem-shape.hpp"
@@ -38,6 +39,30 @@
 namespace analysis
 {
 
+// Compact copy of the deltas a spatial level sent to its children in one
+// iteration, kept for link-transfer detection. Each per-data-space point set is
+// reduced to its corner coordinates, in flat arrays indexed by the child's
+// linear (skewed) id, so comparing two deltas is comparing two runs of ints.
+class SpatialDeltaCorners
+{
+ private:
+  unsigned num_data_spaces_ = 0;
+  // (child, data space) -> first coordinate in corners_, plus an end marker.
+  std::vector<std::size_t> offsets_;
+  std::vector<bool> empty_;
+  std::vector<Coordinate> corners_;
+
+ public:
+  // Children missing from deltas are stored as empty.
+  void Assign(const std::unordered_map<std::uint64_t, problem::OperationSpace>& deltas,
+              std::uint64_t num_children, unsigned num_data_spaces);
+  void clear();
+
+  bool IsEmpty(std::uint64_t child, unsigned pv) const;
+  bool Equals(std::uint64_t child, const SpatialDeltaCorners& other,
+              std::uint64_t other_child, unsigned pv) const;
+};
+
 // ---------------------------------------------------------------
 // Live state for a single spatial element in a single loop level.
 // ---------------------------------------------------------------
@@ -59,7 +84,7 @@ struct ElementState
   // One for each spatial element in next level
 
   // time * element_id
-  std::unordered_map<std::uint64_t, problem::OperationSpace> prev_spatial_deltas;
+  SpatialDeltaCorners prev_spatial_deltas;
   //std::vector<std::unordered_map<std::uint64_t, problem::OperationSpace>> prev_spatial_deltas;
   // std::vector<std::vector<problem::OperationSpace>> prev_spatial_deltas;
 
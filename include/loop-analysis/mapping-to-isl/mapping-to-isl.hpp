@@ -6,8 +6,38 @@
 namespace analysis
 {
 
+/**
+ * @brief Loop bounds kept as ISL parameters instead of constants, keyed by the
+ *   index of the loop in loop::Nest::loops and mapped to the parameter name.
+ *
+ * Occupancies (and everything ReuseAnalysis derives from them) then hold for
+ * every tile size of those loops, so they can be computed once per loop
+ * structure and instantiated many times. Only the outermost loop of a
+ * dimension can be symbolic because inner bounds become strides, which
+ * cannot be affine in a parameter; it must also be perfectly factorized and
+ * must not scale an inner spatial loop of the same fanout.
+ */
+using SymbolicBounds = std::map<std::size_t, std::string>;
+
 std::map<LogicalBuffer, Occupancy>
 OccupanciesFromMapping(const loop::Nest& mapping,
-                       const problem::Workload& workload);
+                       const problem::Workload& workload,
+                       const SymbolicBounds& symbolic_bounds = {});
+
+/**
+ * @brief Outermost temporal loop of every dimension that can be symbolic,
+ *   with parameters named <dimension>_<loop index>.
+ */
+SymbolicBounds
+OutermostSymbolicBounds(const loop::Nest& mapping,
+                        const problem::Workload& workload);
+
+/**
+ * @brief Parameter values instantiating `symbolic_bounds` for `mapping`,
+ *   which has to share the loop structure the bounds were chosen from.
+ */
+std::map<std::string, long>
+SymbolicBoundValues(const loop::Nest& mapping,
+                    const SymbolicBounds& symbolic_bounds);
 
 }; // namespace analysis
@@ -141,7 +141,13 @@ class NestAnalysis
 
   // Other state.
 
+  // True while nest_state_ and the rest of the per-nest state describe
+  // cached_nest. Cleared while ComputeWorkingSets() runs, so that an analysis
+  // that throws part-way is torn down by the next Init().
+  bool nest_initialized_ = false;
   bool working_sets_computed_ = false;
+  bool working_set_sizes_computed_ = false;
+  std::vector<problem::PerDataSpace<std::size_t>> working_set_sizes_;
   bool imperfectly_factorized_ = false;
   std::unordered_map<problem::Shape::FlattenedDimensionID, int> dim_imperfectly_factorized_at_;
 
@@ -163,6 +169,7 @@ class NestAnalysis
 
   void InitializeLiveState();
   void CollectWorkingSets();
+  void CheckWorkingSetsAgainstWalk(const std::string& method);
 
   problem::OperationPoint IndexToOperationPoint_(const std::vector<int>& indices) const;
   bool IsLastGlobalIteration_(int level, problem::Shape::FlattenedDimensionID dim) const;
@@ -198,13 +205,22 @@ class NestAnalysis
       problem::PerDataSpace<std::uint64_t>& link_transfers);
  
   void CompareSpatioTemporalDeltas(
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& cur_spatial_deltas,
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& prev_spatial_deltas,
+    const SpatialDeltaCorners& cur_spatial_deltas,
+    const SpatialDeltaCorners& prev_spatial_deltas,
     const std::uint64_t cur_spatial_index,
     const std::uint64_t prev_spatial_index,
     std::vector<problem::PerDataSpace<bool>>& inter_elem_reuse,
     const problem::PerDataSpace<bool>& ignore_dataspaces);
   
+  static void MulticastHops(const std::vector<std::uint64_t>& match_set,
+                            std::uint64_t h_size, std::uint64_t v_size,
+                            double& hops, double& unicast_hops);
+
+  // Closed-form alternative to ComputeDeltas() for dense, perfectly factorized
+  // nests in which any two tiles of a level are either identical or disjoint.
+  bool ClosedFormApplicable() const;
+  void ComputeClosedFormDeltas();
+
   void ComputeDataDensity();
   void PrintSpaceTimeStamp();
 
@@ -214,17 +230,19 @@ class NestAnalysis
   void Init(problem::Workload* wc, const loop::Nest* nest,
             std::map<unsigned, std::uint64_t> fanoutX_map,
             std::map<unsigned, std::uint64_t> fanoutY_map);
-  void Init(problem::Workload* wc, const loop::Nest* nest, const layout::Layouts layout,
+  void Init(problem::Workload* wc, const loop::Nest* nest, const layout::Layouts& layout,
     std::map<unsigned, std::uint64_t> fanoutX_map,
     std::map<unsigned, std::uint64_t> fanoutY_map);
   void Reset();
  
-  std::vector<problem::PerDataSpace<std::size_t>> GetWorkingSetSizes_LTW() const;
+  const std::vector<problem::PerDataSpace<std::size_t>>& GetWorkingSetSizes_LTW();
 
-  CompoundDataMovementNest GetWorkingSets();
-  CompoundComputeNest GetComputeInfo();
+  // These return references into the analysis state, which stay valid until
+  // the next Init() or Reset(). Copy them if they must outlive that.
+  const CompoundDataMovementNest& GetWorkingSets();
+  const CompoundComputeNest& GetComputeInfo();
   problem::Workload* GetWorkload();
-  layout::Layouts GetLayout();
+  const layout::Layouts& GetLayout();
   bool IsLayoutInitialized();  
 
   // Serialization.
@@ -96,6 +96,10 @@ class AxisAlignedHyperRectangle
   void Add(const AxisAlignedHyperRectangle& s, bool extrude_if_discontiguous = false);
   Gradient Subtract(const AxisAlignedHyperRectangle& s);
   std::vector<AxisAlignedHyperRectangle> MultiSubtract(const AxisAlignedHyperRectangle& b);
+  // The difference MultiSubtract() computes, in place, when it has at most one
+  // AAHR. Returns its number of AAHRs: 0, 1 (now held by this AAHR), or 2 if
+  // there are more, in which case this AAHR is left unchanged.
+  unsigned SubtractUnlessSplintered(const AxisAlignedHyperRectangle& b);
   bool MergeIfAdjacent(const Point& p);
 
   AxisAlignedHyperRectangle& operator += (const Point& p);
@@ -108,6 +112,10 @@ class AxisAlignedHyperRectangle
   Point GetTranslation(const AxisAlignedHyperRectangle& s) const;
   void Translate(const Point& p);
 
+  // Appends the min and max corners. Two AAHRs are equal iff they append
+  // the same coordinates.
+  void AppendCorners(std::vector<Coordinate>& corners) const;
+
   std::vector<double> Centroid() const;
 
   void Print(std::ostream& out = std::cout) const;
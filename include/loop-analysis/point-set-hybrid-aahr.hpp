@@ -0,0 +1,95 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "point-set-multi-aahr.hpp"
+
+// ---------------------------------------------
+//     Hybrid (inline/multi) AAHR Point Set
+// ---------------------------------------------
+
+// The same sets, with the same AAHR decompositions, as MultiAAHR. Nearly all
+// sets in dense analyses are a single hyper-rectangle, so a set of at most one
+// AAHR is held inline and operated on directly. A set is only promoted to a
+// MultiAAHR when it fractures, and is demoted again once it has one AAHR.
+//
+// Setting TIMELOOP_POINT_SET_BACKEND=multi-aahr keeps every set in its
+// MultiAAHR, to validate the inline paths against it.
+
+extern bool gInlineSingleAAHR;
+
+class HybridAAHR
+{
+ protected:
+
+  std::uint32_t order_;
+
+  // Valid if !promoted_: the set is inline_ if num_inline_ is 1, else empty.
+  std::uint32_t num_inline_;
+  AxisAlignedHyperRectangle inline_;
+
+  bool promoted_;
+  MultiAAHR multi_;
+
+  MultiAAHR AsMulti() const;
+  void Promote();
+  void DemoteIfSingle();
+
+ public:
+
+  HybridAAHR() = delete;
+  HybridAAHR(std::uint32_t order);
+  HybridAAHR(std::uint32_t order, const Point unit);
+  HybridAAHR(std::uint32_t order, const Point min, const Point max);
+  HybridAAHR(std::uint32_t order, const std::vector<std::pair<Point, Point>> corner_sets);
+  HybridAAHR(const HybridAAHR& a);
+
+  // Copy-and-swap idiom.
+  HybridAAHR& operator = (HybridAAHR other);
+  friend void swap(HybridAAHR& first, HybridAAHR& second);
+
+  std::size_t size() const;
+  bool empty() const;
+  std::uint32_t numAAHRs() const;
+
+  void Reset();
+
+  void Subtract(const HybridAAHR& other);
+  HybridAAHR& operator += (const Point& p);
+  HybridAAHR& operator += (const HybridAAHR& s);
+  HybridAAHR operator - (const HybridAAHR& other);
+  bool operator == (const HybridAAHR& s) const;
+
+  Point GetTranslation(const HybridAAHR& s) const;
+  void Translate(const Point& p);
+
+  std::vector<AxisAlignedHyperRectangle> GetAAHRs() const;
+  void AppendCorners(std::vector<Coordinate>& corners) const;
+
+  friend std::ostream& operator << (std::ostream& out, const HybridAAHR& h);
+};
@@ -40,6 +40,9 @@ class MultiAAHR
   // This property must be maintained at all times.
   std::vector<AxisAlignedHyperRectangle> aahrs_;
 
+  // Keeps its multi-AAHR sets in a MultiAAHR and works on the AAHRs directly.
+  friend class HybridAAHR;
+
  public:
 
   MultiAAHR() = delete;
@@ -68,6 +71,10 @@ class MultiAAHR
   Point GetTranslation(const MultiAAHR& s) const;
   void Translate(const Point& p);
 
+  // Appends the corners of each AAHR in a canonical order, so that two sets
+  // are equal iff they append the same coordinates.
+  void AppendCorners(std::vector<Coordinate>& corners) const;
+
   //CHECKME: density models need an interface to get the AAHR
   //  more specifically, the min and max points
   //  Is this abstraction correct
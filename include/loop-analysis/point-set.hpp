@@ -40,10 +40,15 @@
 
 #define POINT_SET_AAHR         4
 #define POINT_SET_MULTI_AAHR   5
+#define POINT_SET_HYBRID_AAHR  6
 
-#define POINT_SET_IMPL POINT_SET_MULTI_AAHR
+#define POINT_SET_IMPL POINT_SET_HYBRID_AAHR
 
-#if POINT_SET_IMPL == POINT_SET_MULTI_AAHR
+#if POINT_SET_IMPL == POINT_SET_HYBRID_AAHR
+#include "point-set-hybrid-aahr.hpp"
+typedef HybridAAHR PointSet;
+
+#elif POINT_SET_IMPL == POINT_SET_MULTI_AAHR
 #include "point-set-multi-aahr.hpp"
 typedef MultiAAHR PointSet;
 
@@ -64,6 +64,11 @@ class Point
   Coordinate& operator[] (std::uint32_t i);
   const Coordinate& operator[] (std::uint32_t i) const;
 
+  // Raw coordinates, for hot loops that cannot afford an out-of-line call
+  // per access.
+  Coordinate* data() { return coordinates_.data(); }
+  const Coordinate* data() const { return coordinates_.data(); }
+
   void IncrementAllDimensions(Coordinate m = 1);
 
   // Translation operator.
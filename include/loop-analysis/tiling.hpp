@@ -45,20 +45,25 @@ extern bool gEnableFirstReadElision;
 bool operator < (const DataMovementInfo& a, const DataMovementInfo& b);
 std::ostream& operator << (std::ostream& out, const DataMovementInfo& info);
 
-CompoundTileNest CollapseTiles(analysis::CompoundTileNest& tiles, 
+// The analysis nests are only read, so they can be handed over straight
+// from NestAnalysis without a copy.
+CompoundTileNest CollapseTiles(const analysis::CompoundDataMovementNest& data_movement_nest,
+                               const analysis::CompoundComputeNest& compute_nest,
                                int num_tiling_levels,
                                const CompoundMaskNest& tile_mask,
                                const CompoundMaskNest& distribution_supported,
                                const problem::Workload* workload);
-CompoundDataMovementNest CollapseDataMovementNest(analysis::CompoundDataMovementNest& tiles, 
+CompoundDataMovementNest CollapseDataMovementNest(const analysis::CompoundDataMovementNest& tiles,
                                                   int num_tiling_levels,
                                                   const CompoundMaskNest& tile_mask,
                                                   const CompoundMaskNest& distribution_supported,
                                                   const problem::Workload* workload);
-ComputeNest CollapseComputeNest(analysis::CompoundComputeNest& tiles, int num_tiling_levels);
+ComputeNest CollapseComputeNest(const analysis::CompoundComputeNest& tiles, int num_tiling_levels);
 
 
 NestOfCompoundTiles TransposeTiles(const CompoundTileNest& tiles, const problem::Workload* workload);
+// Same, but moves the tiles out of the nest, which is left unspecified.
+NestOfCompoundTiles TransposeTiles(CompoundTileNest&& tiles, const problem::Workload* workload);
 NestOfCompoundMasks TransposeMasks(const CompoundMaskNest& masks, const problem::Workload* workload);
 bool CheckMaskValidity(const CompoundMaskNest& masks, const problem::Workload* workload);
 
@@ -70,6 +70,18 @@ struct Status
   std::string fail_reason;
 };
 
+//--------------------------------------------//
+//                 Cost Bound                 //
+//--------------------------------------------//
+
+// Lower bounds on the energy and cycles of a set of mappings. The default
+// bound of zero makes no claim.
+struct CostBound
+{
+  double energy = 0;
+  double cycles = 0;
+};
+
 //--------------------------------------------//
 //                  MapSpace                  //
 //--------------------------------------------//
@@ -97,6 +109,15 @@ class MapSpace
 
   virtual std::vector<Status> ConstructMapping(ID mapping_id, Mapping* mapping, bool break_on_failure = true) = 0;
 
+  // Lower bound on the cost of every mapping with the given (local) index
+  // factorization, for dense evaluations. Mapspaces that cannot derive one
+  // make no claim.
+  virtual CostBound IndexFactorizationBound(uint128_t local_index_factorization_id)
+  {
+    (void) local_index_factorization_id;
+    return CostBound();
+  }
+
   std::vector<Status> ConstructMapping(const uint128_t mapping_id, Mapping* mapping, bool break_on_failure = true)
   {
     ID cmapping_id(size_);
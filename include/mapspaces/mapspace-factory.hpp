@@ -42,6 +42,7 @@ MapSpace* ParseAndConstruct(config::CompoundConfigNode config,
                             config::CompoundConfigNode arch_constraints,
                             model::Engine::Specs& arch_specs,
                             const problem::Workload& workload,
-                            bool filter_spatial_fanout = true);
+                            bool filter_spatial_fanout = true,
+                            bool permutation_classes = false);
 
 } // namespace mapspace
@@ -69,6 +69,9 @@ class Ruby : public MapSpace
 
   // Filter Fanout
   bool filter_spatial_fanout_;
+
+  // Enumerate one loop permutation per reuse-equivalence class.
+  bool permutation_classes_;
   
  public:
 
@@ -83,6 +86,7 @@ class Ruby : public MapSpace
     model::Engine::Specs arch_specs,
     const problem::Workload& workload,
     bool filter_spatial_fanout = true,
+    bool permutation_classes = false,
     bool skip_init = false);
   Ruby(const Ruby& other) = default;
   ~Ruby();
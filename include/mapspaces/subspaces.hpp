@@ -108,23 +108,52 @@ class PermutationSpace
   };
   std::vector<problem::Shape::FlattenedDimensionID> canonical_pattern_;
 
+  // Per data space: the dimensions its projection depends on, and whether
+  // every rank is indexed by a single dimension (so that its tiles along
+  // a loop never overlap).
+  std::vector<std::uint64_t> relevant_dimensions_;
+  std::vector<bool> disjoint_tiles_;
+
+  // Reuse-class representatives, by (non-unit inner loops, permutable
+  // loops, outer loops).
+  std::map<std::vector<std::vector<problem::Shape::FlattenedDimensionID>>,
+           std::vector<std::uint64_t>> representatives_cache_;
+
  protected:
   std::uint64_t num_levels_;
   std::map<unsigned, Pattern> patterns_;
   std::map<unsigned, std::uint64_t> size_;    
+  // Permutation indices of the permutable loops at each level, if only
+  // reuse-class representatives are enumerated.
+  std::map<unsigned, std::vector<std::uint64_t>> representatives_;
   Factoradic<problem::Shape::FlattenedDimensionID> factoradic_;
   const problem::Workload& workload_;
 
+  const std::vector<std::uint64_t>& ReuseClassRepresentatives(
+    const std::vector<problem::Shape::FlattenedDimensionID>& inner,
+    const std::vector<problem::Shape::FlattenedDimensionID>& permutable,
+    const std::vector<problem::Shape::FlattenedDimensionID>& outer);
+
+  std::uint64_t PermutationIndex(unsigned level, std::uint64_t local_id) const;
+
  public:
   PermutationSpace() = delete;
   PermutationSpace(const problem::Workload& workload);
 
   void Init(uint64_t num_levels);
   virtual void InitLevelCanonical(uint64_t level);
+
+  // With reuse_classes, only one permutation is enumerated per class of
+  // permutations that give every data space the same reuse: for each data
+  // space, the same loops inside its innermost relevant loop (or, for
+  // projections with sliding windows, the same interleaving of irrelevant
+  // loops with its relevant ones). This is only sound for temporal levels
+  // whose pruned_dimensions are exactly the unit-factor dimensions.
   virtual void InitLevel(uint64_t level,
                          std::vector<problem::Shape::FlattenedDimensionID> user_prefix,
                          std::vector<problem::Shape::FlattenedDimensionID> user_suffix,
-                         std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions = {});
+                         std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions = {},
+                         bool reuse_classes = false);
 
   virtual std::vector<std::vector<problem::Shape::FlattenedDimensionID>> GetPatterns(uint128_t id);
 
@@ -152,7 +181,8 @@ class RubyPermutationSpace : public PermutationSpace
     void InitLevel(uint64_t level,
                   std::vector<problem::Shape::FlattenedDimensionID> user_prefix,
                   std::vector<problem::Shape::FlattenedDimensionID> user_suffix,
-                  std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions = {});
+                  std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions = {},
+                  bool reuse_classes = false);
 
     std::vector<std::vector<problem::Shape::FlattenedDimensionID>> GetPatterns(uint128_t id);
 
@@ -70,6 +70,9 @@ class Uber : public MapSpace
 
   // Filter Fanout
   bool filter_spatial_fanout_;
+
+  // Enumerate one loop permutation per reuse-equivalence class.
+  bool permutation_classes_;
  
  public:
 
@@ -84,6 +87,7 @@ class Uber : public MapSpace
     model::Engine::Specs arch_specs,
     const problem::Workload& workload,
     bool filter_spatial_fanout = true,
+    bool permutation_classes = false,
     bool skip_init = false);
   Uber(const Uber& other) = default;
   ~Uber();
@@ -98,6 +102,7 @@ class Uber : public MapSpace
   void InitSpatialSpace(std::map<unsigned, unsigned> unit_factors = {});
   void InitDatatypeBypassNestSpace();
   void InitPruned(uint128_t index_factorization_id);
+  CostBound IndexFactorizationBound(uint128_t index_factorization_id);
 
   // Split the mapspace (used for parallelization).
   std::vector<MapSpace*> Split(std::uint64_t num_splits);
@@ -0,0 +1,267 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/mpl/bool.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/serialization.hpp>
+
+#include "model/attribute.hpp"
+#include "workload/util/per-data-space.hpp"
+
+namespace model
+{
+
+//
+// Compact columnar stats, an alternative to the XML archive for consumers
+// that only need the numbers. Every stat is a named column of float64
+// values: one value for a scalar, one per data space for a PerDataSpace<>.
+// Column names are dotted paths that follow the XML element names, e.g.,
+// "GlobalBuffer.stats_.reads".
+//
+// File layout (version 1, all integers and values little-endian):
+//
+//   offset  size        field
+//   0       8           magic "TLSTATS\0"
+//   8       4           u32 version
+//   12      4           u32 number of columns, C
+//   16      8           u64 offset of the name blob
+//   24      8           u64 offset of the value block (8-byte aligned)
+//   32      24*C        directory, one entry per column:
+//                         u32 name offset (within the name blob)
+//                         u32 name length
+//                         u64 index of the first value (within the block)
+//                         u64 number of values
+//   ...                 name blob (UTF-8, not NUL-terminated)
+//   ...                 value block, float64
+//
+// Counters are stored as float64, so they are exact up to 2^53.
+//
+
+class ColumnarStats
+{
+ public:
+  static constexpr char kMagic[8] = {'T', 'L', 'S', 'T', 'A', 'T', 'S', '\0'};
+  static constexpr std::uint32_t kVersion = 1;
+
+  void Add(const std::string& name, std::vector<double> values);
+  void Add(const std::string& name, double value) { Add(name, std::vector<double>{value}); }
+
+  // Adds a column for every numeric member reached through the object's
+  // boost serialize() function, under the given prefix.
+  template <class T>
+  void AddObject(const std::string& prefix, const T& object);
+
+  const std::vector<std::pair<std::string, std::vector<double>>>& Columns() const
+  {
+    return columns_;
+  }
+
+  void Write(std::ostream& out) const;
+
+ private:
+  std::vector<std::pair<std::string, std::vector<double>>> columns_;
+};
+
+//
+// Read-only view of a columnar stats file. The file is memory-mapped, so
+// opening it is cheap and values are only paged in when they are read.
+//
+
+class ColumnarStatsReader
+{
+ public:
+  ColumnarStatsReader(const std::string& path);
+  ~ColumnarStatsReader();
+
+  ColumnarStatsReader(const ColumnarStatsReader&) = delete;
+  ColumnarStatsReader& operator=(const ColumnarStatsReader&) = delete;
+
+  std::uint32_t Version() const { return version_; }
+  std::size_t NumColumns() const { return num_columns_; }
+  std::string Name(std::size_t column) const;
+  std::size_t Size(std::size_t column) const;
+  const double* Values(std::size_t column) const;
+
+  // Column index by name, or NumColumns() if absent.
+  std::size_t Find(const std::string& name) const;
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t length_ = 0;
+  std::uint32_t version_ = 0;
+  std::size_t num_columns_ = 0;
+  std::uint64_t names_offset_ = 0;
+  std::uint64_t values_offset_ = 0;
+
+  const char* Entry(std::size_t column) const;
+};
+
+//
+// Member types that have no numeric representation and get no column.
+// Every other member must be numeric, a PerDataSpace<>, vector or
+// Attribute<> of numbers, or a class with a boost serialize() function;
+// anything else fails to compile rather than silently dropping stats.
+//
+
+template <class T>
+struct ColumnarStatsSkipped : std::is_pointer<T> {};
+
+template <>
+struct ColumnarStatsSkipped<std::string> : std::true_type {};
+
+template <class T>
+struct ColumnarStatsSkipped<std::shared_ptr<T>> : std::true_type {};
+
+template <class K, class V, class... Rest>
+struct ColumnarStatsSkipped<std::map<K, V, Rest...>> : std::true_type {};
+
+template <class K, class V, class... Rest>
+struct ColumnarStatsSkipped<std::unordered_map<K, V, Rest...>> : std::true_type {};
+
+//
+// A boost-compatible output archive that turns NVP-tagged members into
+// columns, recursing into classes through their serialize() functions.
+// Vectors and PerDataSpace<>s of non-numbers are skipped.
+//
+
+class ColumnarStatsArchive
+{
+ public:
+  typedef boost::mpl::true_ is_saving;
+  typedef boost::mpl::false_ is_loading;
+
+  ColumnarStatsArchive(ColumnarStats& stats, const std::string& prefix) :
+      stats_(stats),
+      prefix_(prefix)
+  {
+  }
+
+  unsigned int get_library_version() const { return 0; }
+
+  template <class T>
+  ColumnarStatsArchive& operator&(const boost::serialization::nvp<T>& t)
+  {
+    Visit(Join(t.name()), t.value());
+    return *this;
+  }
+
+  template <class T>
+  ColumnarStatsArchive& operator<<(const boost::serialization::nvp<T>& t)
+  {
+    return *this & t;
+  }
+
+  // Un-named members carry no column name.
+  template <class T>
+  ColumnarStatsArchive& operator&(const T&)
+  {
+    return *this;
+  }
+
+  template <class T>
+  void VisitObject(const std::string& path, T& object)
+  {
+    ColumnarStatsArchive nested(stats_, path);
+    boost::serialization::serialize_adl(nested, object, 0);
+  }
+
+ private:
+  ColumnarStats& stats_;
+  std::string prefix_;
+
+  std::string Join(const char* name) const
+  {
+    return prefix_.empty() ? std::string(name) : prefix_ + "." + name;
+  }
+
+  template <class T>
+  void Visit(const std::string& path, const T& value)
+  {
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+      stats_.Add(path, double(value));
+    }
+    else if constexpr (!ColumnarStatsSkipped<T>::value)
+    {
+      static_assert(std::is_class<T>::value, "ColumnarStats: member has no column representation");
+      VisitObject(path, const_cast<T&>(value));
+    }
+  }
+
+  template <class T>
+  void Visit(const std::string& path, const problem::PerDataSpace<T>& values)
+  {
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+      stats_.Add(path, std::vector<double>(values.begin(), values.end()));
+    }
+  }
+
+  template <class T>
+  void Visit(const std::string& path, const std::vector<T>& values)
+  {
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+      stats_.Add(path, std::vector<double>(values.begin(), values.end()));
+    }
+  }
+
+  // Unspecified attributes get no column; specified ones appear under the
+  // attribute's own name rather than the "t_" the XML archive nests them in.
+  template <class T>
+  void Visit(const std::string& path, const Attribute<T>& attribute)
+  {
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+      if (attribute.IsSpecified())
+      {
+        stats_.Add(path, double(attribute.Get()));
+      }
+    }
+  }
+};
+
+template <class T>
+void ColumnarStats::AddObject(const std::string& prefix, const T& object)
+{
+  ColumnarStatsArchive ar(*this, prefix);
+  ar.VisitObject(prefix, const_cast<T&>(object));
+}
+
+} // namespace model
@@ -86,8 +86,10 @@ class Engine : public Module
 
   std::vector<EvalStatus> PreEvaluationCheck(const Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true);
 
-  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, layout::Layouts layout, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true);
-  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true);
+  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, const layout::Layouts& layout, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true,
+                                   const EvalBound& bound = EvalBound());
+  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure = true,
+                                   const EvalBound& bound = EvalBound());
   
   double Energy() const;
   double Area() const;
@@ -37,6 +37,9 @@ struct EvalStatus
 {
   bool success;
   std::string fail_reason;
+  // The evaluation was cut short because the mapping cannot beat the
+  // EvalBound it was given. Always comes with success = false.
+  bool dominated = false;
 };
 
 //--------------------------------------------//
@@ -31,6 +31,7 @@ algorithmic contributors may be used tactual or promote products derived
 #include <memory>
 #include <algorithm>
 #include <fstream>
+#include <limits>
 
 #include "loop-analysis/tiling.hpp"
 #include "loop-analysis/tiling-tile-info.hpp"
@@ -40,6 +41,7 @@ algorithmic contributors may be used tactual or promote products derived
 #include "model/level.hpp"
 #include "model/arithmetic.hpp"
 #include "model/buffer.hpp"
+#include "model/columnar-stats.hpp"
 #include "compound-config/compound-config.hpp"
 #include "network.hpp"
 #include "network-legacy.hpp"
@@ -110,6 +112,29 @@ bool isBufferClass(std::string className);
 bool isComputeClass(std::string className);
 bool isNetworkClass(std::string className);
 
+// Branch-and-bound cutoff for Topology::Evaluate(). Energy and cycles only
+// grow as levels are evaluated, so once the cost under the given metric of
+// what has been accumulated so far exceeds cost, the evaluation is abandoned
+// and every level is reported as dominated. The default bound never cuts.
+struct EvalBound
+{
+  enum class Metric { Energy, Delay, EDP };
+
+  Metric metric = Metric::Energy;
+  double cost = std::numeric_limits<double>::infinity();
+
+  bool Exceeded(double energy, std::uint64_t cycles) const
+  {
+    switch (metric)
+    {
+      case Metric::Energy: return energy > cost;
+      case Metric::Delay: return double(cycles) > cost;
+      case Metric::EDP: return energy * double(cycles) > cost;
+    }
+    return false;
+  }
+};
+
 class Topology : public Module
 {
  public:
@@ -349,7 +374,8 @@ class Topology : public Module
   unsigned NumNetworks() const;
 
   std::vector<EvalStatus> PreEvaluationCheck(const Mapping& mapping, analysis::NestAnalysis* analysis, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure);
-  std::vector<EvalStatus> Evaluate(Mapping& mapping, analysis::NestAnalysis* analysis, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure);
+  std::vector<EvalStatus> Evaluate(Mapping& mapping, analysis::NestAnalysis* analysis, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure,
+                                   const EvalBound& bound = EvalBound());
 
   inline const Stats& GetStats() const { return stats_; }
   inline const Specs& GetSpecs() const { return specs_; }
@@ -369,6 +395,10 @@ class Topology : public Module
   void PrintOrojenesis(problem::Workload* workload, std::ostream& out, Mapping& mapping, bool log_mappings_yaml, bool log_mappings_verbose, std::string orojenesis_prefix, unsigned thread_id) const;
   void OutputOrojenesisMappingYAML(Mapping& mapping, std::string map_yaml_file_name) const;
 
+  // Columnar alternative to the XML archive: the topology-wide stats plus
+  // every stat of each level and network, named after its XML path.
+  void ExportStats(ColumnarStats& out) const;
+
   friend std::ostream& operator<<(std::ostream& out, const Topology& sh);
 };
 
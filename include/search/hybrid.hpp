@@ -37,6 +37,7 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/if-pruner.hpp"
 
 namespace search
 {
@@ -56,15 +57,22 @@ class HybridSearch : public SearchAlgorithm
   unsigned id_;
   bool filter_revisits_;
 
-  // Submodules.
+  // Submodules. With filter_revisits, index factorizations are drawn from a
+  // pseudorandom permutation instead, which never repeats.
   RandomGenerator128 if_pgen_;
+  PermutationGenerator128 if_perm_;
+  IndexFactorizationPruner pruner_;
+
+  // With pruning and filter_revisits, small index-factorization spaces are
+  // visited best bound first.
+  std::vector<std::pair<double, uint128_t>> ranked_;
+  std::size_t next_ranked_;
   
   // Live state.
   State state_;
   std::array<uint128_t, unsigned(mapspace::Dimension::Num)> iterator_;
   uint128_t valid_mappings_;
   std::uint64_t eval_fail_count_;
-  std::unordered_set<uint128_t> visited_;
 
   double best_cost_;
   std::ofstream best_cost_file_;
@@ -80,7 +88,8 @@ class HybridSearch : public SearchAlgorithm
   };
   
  public:
-  HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id);
+  HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+               const IndexFactorizationPruner& pruner);
 
   ~HybridSearch();
 
@@ -89,6 +98,10 @@ class HybridSearch : public SearchAlgorithm
   bool Next(mapspace::ID& mapping_id);
 
   void Report(Status status, double cost = 0);
+
+  void UpdateIncumbent(double cost);
+
+  void PrintStats(std::ostream& out) const;
 };
 
 } // namespace search
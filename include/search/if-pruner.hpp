@@ -0,0 +1,93 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mapspaces/mapspace-base.hpp"
+
+namespace search
+{
+
+//
+// Skips index factorizations whose analytic lower bound (see
+// MapSpace::IndexFactorizationBound()) under the optimization metric is
+// worse than the incumbent, i.e., the best cost found so far. A pruner
+// without a mapspace is disabled and never prunes.
+//
+class IndexFactorizationPruner
+{
+ public:
+  // Index-factorization spaces up to this size are ranked best bound first.
+  static constexpr std::size_t kMaxRanked = 1 << 16;
+
+  // Random draws hand out a dominated index factorization after this many
+  // consecutive prunes, so that the mapper's termination counters advance.
+  static constexpr unsigned kMaxConsecutivePrunes = 1024;
+
+ private:
+  mapspace::MapSpace* mapspace_;
+  model::EvalBound::Metric metric_;
+  double incumbent_;
+
+  // Stats.
+  std::uint64_t scored_;
+  std::uint64_t pruned_;
+
+ public:
+  IndexFactorizationPruner(mapspace::MapSpace* mapspace = nullptr, const std::string& metric = "energy");
+
+  static bool SupportsMetric(const std::string& metric);
+
+  bool Enabled() const { return mapspace_ != nullptr; }
+
+  // Tightens the incumbent with the cost of a mapping that has been found.
+  void UpdateIncumbent(double cost);
+
+  // Cost bound of an index factorization under the optimization metric.
+  double Score(uint128_t index_factorization_id);
+
+  // Whether a mapping with this cost bound can't beat the incumbent.
+  bool Dominated(double score) const;
+
+  // Scores an index factorization and counts it as pruned if dominated.
+  bool Prune(uint128_t index_factorization_id);
+  void CountPruned(std::uint64_t count);
+
+  // All index factorizations in the (split) mapspace with their scores,
+  // best bound first.
+  std::vector<std::pair<double, uint128_t>> Rank();
+
+  void PrintStats(std::ostream& out) const;
+};
+
+} // namespace search
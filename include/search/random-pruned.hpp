@@ -36,6 +36,7 @@
 #include "mapspaces/mapspace-base.hpp"
 #include "util/misc.hpp"
 #include "search/search.hpp"
+#include "search/if-pruner.hpp"
 
 namespace search
 {
@@ -58,6 +59,7 @@ class RandomPrunedSearch : public SearchAlgorithm
   // Submodules.
   RandomGenerator128 if_pgen_;
   RandomGenerator128 lp_pgen_;
+  IndexFactorizationPruner pruner_;
   
   // Live state.
   State state_;
@@ -66,7 +68,6 @@ class RandomPrunedSearch : public SearchAlgorithm
   uint128_t permutations_visited_;
   uint128_t valid_mappings_;
   std::uint64_t eval_fail_count_;
-  std::unordered_set<uint128_t> visited_;
 
   double best_cost_;
   std::ofstream best_cost_file_;
@@ -82,7 +83,8 @@ class RandomPrunedSearch : public SearchAlgorithm
   };
   
  public:
-  RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id);
+  RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                     const IndexFactorizationPruner& pruner);
 
   ~RandomPrunedSearch();
 
@@ -91,6 +93,10 @@ class RandomPrunedSearch : public SearchAlgorithm
   bool Next(mapspace::ID& mapping_id);
 
   void Report(Status status, double cost = 0);
+
+  void UpdateIncumbent(double cost);
+
+  void PrintStats(std::ostream& out) const;
 };
 
 } // namespace search
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "search/search.hpp"
 #include "compound-config/compound-config.hpp"
 
@@ -37,8 +39,12 @@ namespace search
 //             Parser and Factory             //
 //--------------------------------------------//
 
+// The optimization metric and whether evaluations are dense only matter to
+// the analytic index-factorization bounds (prune_index_factorizations).
 SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
                                    mapspace::MapSpace* mapspace,
-                                   unsigned id);
+                                   unsigned id,
+                                   const std::string& metric,
+                                   bool dense);
 
 } // namespace search
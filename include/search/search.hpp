@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <iostream>
+
 #include "mapspaces/mapspace-base.hpp"
 
 namespace search
@@ -46,6 +48,12 @@ class SearchAlgorithm
   virtual ~SearchAlgorithm() {}
   virtual bool Next(mapspace::ID& mapping_id) = 0;
   virtual void Report(Status status, double cost = 0) = 0;
+
+  // Best cost found so far by any search, e.g., another mapper thread.
+  virtual void UpdateIncumbent(double cost) { (void) cost; }
+
+  // Search-specific statistics, printed when the search terminates.
+  virtual void PrintStats(std::ostream& out) const { (void) out; }
 };
 
 } // namespace search
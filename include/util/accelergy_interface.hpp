@@ -30,11 +30,28 @@
 #include <string>
 #include <vector>
 
+namespace config
+{
+class CompoundConfig;
+}
+
 namespace accelergy
 {
 
 std::string exec(const char* cmd);
 
-void invokeAccelergy(std::vector<std::string> input_files, std::string out_prefix, std::string out_dir);
+// Identifies the tables Accelergy generates for a configuration: a hash of
+// every hardware-relevant input section (everything but the workload, mapping,
+// mapper and model settings) and of the Accelergy installation. Empty if the
+// configuration cannot be keyed.
+std::string cacheKey(config::CompoundConfig* config);
+
+// Generates <out_dir>/<out_prefix>.ERT.yaml and .ART.yaml. If the
+// TIMELOOP_ACCELERGY_CACHE environment variable names a directory and the
+// configuration is given, tables generated earlier for the same cacheKey()
+// are copied from there instead of invoking Accelergy, and newly generated
+// tables are added. The key is only computed when the cache is enabled.
+void invokeAccelergy(std::vector<std::string> input_files, std::string out_prefix, std::string out_dir,
+                     config::CompoundConfig* config = nullptr);
 
 } // namespace accelergy
@@ -28,8 +28,10 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <cassert>
+#include <type_traits>
 
 // This is meant to be a drop-in replacement for std::array
 // that does not need a statically constant size,
@@ -39,58 +41,154 @@
 // after constructing it, but std::vector<bool> is an abomination that prevents
 // generic programming. This class avoids the problems of std::vector<bool>.
 // Note that this means it does *not* store bitmaps efficiently.
+//
+// Arrays of up to kInlineCapacity small trivial elements (the
+// per-data-space and per-dimension counters of the model) are stored inline,
+// so creating, copying or moving them does not touch the heap.
 template<class T>
 class DynamicArray
 {
+ public:
+  static constexpr size_t kInlineCapacity =
+    (std::is_trivial<T>::value && sizeof(T) <= 8) ? 8 : 0;
+
  private:
   size_t size_;
   T* data_;
+  std::array<T, kInlineCapacity> inline_;
+
+  bool IsInline() const { return size_ <= kInlineCapacity; }
+
+  // Points data_ at storage for size elements; the contents are unspecified.
+  void Allocate(size_t size)
+  {
+    size_ = size;
+    data_ = IsInline() ? inline_.data() : new T[size_];
+  }
+
+  void Release()
+  {
+    if (!IsInline())
+    {
+      delete[] data_;
+    }
+  }
 
  public:
   DynamicArray(size_t size) :
-    size_(size),
-    data_(new T[size]())
+    size_(size)
   {
+    if (IsInline())
+    {
+      data_ = inline_.data();
+      std::fill(begin(), end(), T());
+    }
+    else
+    {
+      data_ = new T[size_]();
+    }
   }
 
-  DynamicArray(const DynamicArray& other) :
-    size_(other.size_),
-    data_(new T[size_])
+  DynamicArray(const DynamicArray& other)
   {
+    Allocate(other.size_);
     std::copy(other.begin(), other.end(), begin());
   }
 
-  DynamicArray(std::initializer_list<T> l) :
-    size_(l.size()),
-    data_(new T[size_])
+  // Without this, returning or moving a PerDataSpace deep-copies it.
+  DynamicArray(DynamicArray&& other) noexcept
   {
+    if (other.IsInline())
+    {
+      Allocate(other.size_);
+      std::copy(other.begin(), other.end(), begin());
+      other.size_ = 0;
+    }
+    else
+    {
+      size_ = other.size_;
+      data_ = other.data_;
+      other.size_ = 0;
+      other.data_ = other.inline_.data();
+    }
+  }
+
+  DynamicArray(std::initializer_list<T> l)
+  {
+    Allocate(l.size());
     std::copy(l.begin(), l.end(), begin());
   }
 
-  // This is the copy-and-swap idiom.
-  DynamicArray<T>& operator=(DynamicArray other) {
-    swap(*this, other);
+  DynamicArray<T>& operator=(const DynamicArray& other)
+  {
+    if (this != &other)
+    {
+      if (size_ != other.size_)
+      {
+        Release();
+        Allocate(other.size_);
+      }
+      std::copy(other.begin(), other.end(), begin());
+    }
+    return *this;
+  }
+
+  DynamicArray<T>& operator=(DynamicArray&& other) noexcept
+  {
+    if (this != &other)
+    {
+      if (other.IsInline())
+      {
+        Release();
+        Allocate(other.size_);
+        std::copy(other.begin(), other.end(), begin());
+        other.size_ = 0;
+      }
+      else
+      {
+        Release();
+        size_ = other.size_;
+        data_ = other.data_;
+        other.size_ = 0;
+        other.data_ = other.inline_.data();
+      }
+    }
     return *this;
   }
 
   friend void swap(DynamicArray& first, DynamicArray& second)
   {
-    using std::swap;
-    swap(first.size_, second.size_);
-    swap(first.data_, second.data_);
+    if (!first.IsInline() && !second.IsInline())
+    {
+      std::swap(first.size_, second.size_);
+      std::swap(first.data_, second.data_);
+    }
+    else
+    {
+      DynamicArray temp(std::move(first));
+      first = std::move(second);
+      second = std::move(temp);
+    }
   }
 
   ~DynamicArray()
   {
-    delete[] data_;
+    Release();
   }
 
   size_t size() const { return size_; }
 
   void clear()
   {
-    delete[] data_;
-    data_ = new T[size_];
+    if (IsInline())
+    {
+      std::fill(begin(), end(), T());
+    }
+    else
+    {
+      delete[] data_;
+      data_ = new T[size_];
+    }
   }
 
   T & operator [] (size_t i)
@@ -50,14 +50,34 @@ class Factors
  private:
   unsigned long n_;
   std::vector<unsigned long> all_factors_;
-  std::vector<std::vector<unsigned long>> cofactors_;
+
+  // Cofactor sets are never materialized. The free (non-given) positions
+  // multiply to remaining_; a set is unranked by filling free positions from
+  // last to first, trying factors in all_factors_ order, and counting how many
+  // completions each choice has. This is the order in which the recursive
+  // split used to enumerate them.
+  unsigned long remaining_;
+  int order_;
+  std::map<unsigned, unsigned long> given_;
+  std::vector<unsigned> free_positions_;
+  std::map<unsigned, unsigned long> max_;
+  std::map<unsigned, unsigned long> min_;
+
+  // num_splits_[s][i]: ways to split sorted_factors_[i] across free positions
+  // 0..s while honoring min/max constraints.
+  std::vector<unsigned long> sorted_factors_;
+  std::vector<std::vector<std::uint64_t>> num_splits_;
+  std::uint64_t size_;
 
   unsigned long ISqrt_(unsigned long x);
 
   void CalculateAllFactors_(unsigned long of);
 
-  // Return a vector of all order-way cofactor sets of n.
-  std::vector<std::vector<unsigned long>> MultiplicativeSplitRecursive_(unsigned long n, int order);
+  void Init_(const unsigned long remaining, const int order);
+
+  bool InBounds_(unsigned position, unsigned long factor) const;
+  std::size_t FactorIndex_(unsigned long factor) const;
+  void CountSplits_();
 
  public:
   Factors();
@@ -67,9 +87,10 @@ class Factors
   void PruneMax(std::map<unsigned, unsigned long>& max);
   void PruneMin(std::map<unsigned, unsigned long>& min);
 
-  std::vector<unsigned long>& operator[](int index);
+  // Unranks the index-th cofactor set.
+  std::vector<unsigned long> operator[](std::uint64_t index) const;
 
-  std::size_t size();
+  std::size_t size() const;
 
   void Print();
   void PrintAllFactors();
@@ -641,6 +662,35 @@ class RandomGenerator128 final : public PatternGenerator128
   uint128_t Next();
 };
 
+// Visits [0, bound) in a keyed pseudorandom order without repeats, using O(1)
+// state. The order is a Feistel network over the smallest even-width binary
+// domain covering bound, cycle-walked back into [0, bound). Different keys
+// give different orders.
+class PermutationGenerator128 final : public PatternGenerator128
+{
+ private:
+  static const unsigned NumRounds = 6;
+
+  unsigned half_bits_;
+  std::uint64_t half_mask_;
+  std::array<std::uint64_t, NumRounds> round_keys_;
+  uint128_t cur_;
+
+  uint128_t Encrypt_(uint128_t x) const;
+
+ public:
+  PermutationGenerator128(uint128_t bound, std::uint64_t key = 0);
+
+  // Image of index under the permutation.
+  uint128_t At(uint128_t index) const;
+
+  // Returns the next value of the current pass; a new pass (in the same
+  // order) starts once every value has been returned.
+  uint128_t Next();
+
+  bool Exhausted() const { return cur_ >= bound_; }
+};
+
 //------------------------------------
 //           Miscellaneous
 //------------------------------------
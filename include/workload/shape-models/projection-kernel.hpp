@@ -0,0 +1,91 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "loop-analysis/point.hpp"
+#include "workload/shape-models/problem-shape.hpp"
+
+namespace problem
+{
+
+// ======================================== //
+//             ProjectionKernel             //
+// ======================================== //
+//
+// The projection of factorized problem space onto one data space, compiled
+// for a given set of coefficient values. Each data-space dimension is a dot
+// product of a fixed number of (coefficient, dimension) terms, with shorter
+// expressions padded by zero-coefficient terms. The common shapes (e.g., the
+// CNN layer and GEMM) have data spaces of rank <= 4 with <= 2 terms per rank;
+// these are dispatched to kernels with compile-time trip counts. All other
+// shapes use the same layout with run-time trip counts.
+
+class ProjectionKernel
+{
+ public:
+  ProjectionKernel() = default;
+  ProjectionKernel(const Shape& shape, Shape::DataSpaceID d,
+                   const std::map<Shape::CoefficientID, int>& coefficients);
+
+  unsigned Rank() const { return rank_; }
+
+  void Project(const Point& factorized, Point& data_space) const
+  {
+    project_(*this, factorized, data_space);
+  }
+
+  // Projects an AAHR given by its inclusive corners.
+  void ProjectLowHigh(const Point& factorized_low, const Point& factorized_high,
+                      Point& data_space_low, Point& data_space_high) const
+  {
+    project_low_high_(*this, factorized_low, factorized_high, data_space_low, data_space_high);
+  }
+
+ private:
+  unsigned rank_ = 0;
+  unsigned num_terms_ = 0;
+  std::vector<Shape::FactorizedDimensionID> dims_; // [rank_][num_terms_]
+  std::vector<Coordinate> coefficients_;           // [rank_][num_terms_]
+
+  void (*project_)(const ProjectionKernel&, const Point&, Point&) = nullptr;
+  void (*project_low_high_)(const ProjectionKernel&, const Point&, const Point&,
+                            Point&, Point&) = nullptr;
+
+  template <unsigned Rank, unsigned NumTerms>
+  static void ProjectImpl(const ProjectionKernel& k, const Point& factorized,
+                          Point& data_space);
+  template <unsigned Rank, unsigned NumTerms>
+  static void ProjectLowHighImpl(const ProjectionKernel& k,
+                                 const Point& factorized_low, const Point& factorized_high,
+                                 Point& data_space_low, Point& data_space_high);
+};
+
+} // namespace problem
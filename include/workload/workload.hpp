@@ -34,6 +34,7 @@
 #include "compound-config/compound-config.hpp"
 
 #include "shape-models/problem-shape.hpp"
+#include "shape-models/projection-kernel.hpp"
 #include "density-models/density-distribution.hpp"
 #include "density-models/density-distribution-factory.hpp"
 
@@ -75,6 +76,22 @@ class Workload
   bool default_dense_ = true;
   Shape shape_;
 
+  // Projections compiled for the current coefficients, one per data space.
+  // Empty until both the shape and the coefficients are known.
+  std::vector<ProjectionKernel> projection_kernels_;
+
+  void CompileProjections()
+  {
+    projection_kernels_.clear();
+    for (unsigned i = 0; i < shape_.NumCoefficients; i++)
+    {
+      if (coefficients_.count(i) == 0)
+        return;
+    }
+    for (unsigned d = 0; d < shape_.NumDataSpaces; d++)
+      projection_kernels_.emplace_back(shape_, d, coefficients_);
+  }
+
   // For making sure only one Workload is alive at a time
   static bool workload_alive_;
   static const Shape* current_shape_;
@@ -123,6 +140,11 @@ class Workload
     return coefficients_.at(p);
   }
 
+  const ProjectionKernel* GetProjectionKernel(Shape::DataSpaceID d) const
+  {
+    return d < projection_kernels_.size() ? &projection_kernels_[d] : nullptr;
+  }
+
   std::shared_ptr<DensityDistribution> GetDensity(Shape::DataSpaceID pv) const
   {
     return densities_.at(pv);
@@ -158,6 +180,7 @@ class Workload
   void SetCoefficients(const Coefficients& coefficients)
   {
     coefficients_ = coefficients;
+    CompileProjections();
   }
   
   void SetDensities(const Densities& densities)
@@ -188,6 +211,7 @@ class Workload
   void ParseShape(config::CompoundConfigNode config)
   {
     shape_.Parse(config);
+    CompileProjections();
   }
 
  private:
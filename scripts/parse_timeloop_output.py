@@ -27,10 +27,12 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 import argparse
+import mmap
 import numpy as np
 import os
 import pickle
 import pprint
+import struct
 import xml.etree.ElementTree as ET
 
 #FIXME assumes 1 arithmetic level and names it MAC
@@ -233,11 +235,33 @@ def parse_timeloop_stats(filename):
 
     return output
 
+def parse_columnar_stats(filename):
+    """Reads a columnar stats file (model.stats_format: columnar) into a dict
+    mapping each column name to a float64 array. The arrays are views over
+    the memory-mapped file. See include/model/columnar-stats.hpp for the
+    layout."""
+    with open(filename, 'rb') as f:
+        data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+    magic, version, num_columns, names_offset, values_offset = struct.unpack_from('<8sIIQQ', data, 0)
+    if magic != b'TLSTATS\0':
+        raise ValueError('%s is not a stats file' % filename)
+    if version > 1:
+        raise ValueError('%s has unsupported version %d' % (filename, version))
+
+    values = np.frombuffer(data, dtype='<f8', offset=values_offset)
+    output = {}
+    for column in range(num_columns):
+        name_pos, name_len, value_pos, count = struct.unpack_from('<IIQQ', data, 32 + 24*column)
+        name = data[names_offset + name_pos : names_offset + name_pos + name_len].decode('utf-8')
+        output[name] = values[value_pos : value_pos + count]
+    return output
+
 def main():
     parser = argparse.ArgumentParser(
             description='A simple tool for generating pickle files from timeloop output.')
     parser.add_argument('infile', nargs='?', default=xml_file_name, type=str,
-            help='raw Timeloop XML output file')
+            help='raw Timeloop XML output file, or a columnar .stats.bin file')
     parser.add_argument('outfile', nargs='?', default='timeloop-output.pkl', type=argparse.FileType('wb'),
             help='write the output of infile to outfile')
     options = parser.parse_args()
@@ -245,7 +269,10 @@ def main():
     infile = options.infile
     outfile = options.outfile
 
-    output = parse_timeloop_stats(infile)
+    if infile.endswith('.bin'):
+        output = parse_columnar_stats(infile)
+    else:
+        output = parse_timeloop_stats(infile)
     pprint.pprint(output)
 
     with outfile:
@@ -131,3 +131,38 @@ def run_timeloop(dirname, configfile, logfile='timeloop.log', workload_bounds=No
     for f in output_file_names:
         if os.path.exists(f):
             os.rename(f, dirname + '/' + f)
+
+def evaluate_on_server(socket_path, config, mappings):
+    """Evaluate mappings on a running timeloop-model-server.
+
+    config is a timeloop-model input (problem, arch, ERT, ...) as a dict and
+    mappings is a list of mapping dicts. Returns one dict per mapping with
+    'success' and either 'energy', 'cycles', 'utilization' or 'reason'.
+    """
+    import socket
+
+    request = dict(config)
+    request.pop('mapping', None)
+    request['mappings'] = mappings
+    payload = yaml.dump(request).encode()
+
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(socket_path)
+        sock.sendall(str(len(payload)).encode() + b'\n' + payload)
+
+        stream = sock.makefile('rb')
+        length = int(stream.readline())
+        response = stream.read(length).decode()
+
+    results = []
+    for line in response.splitlines():
+        fields = line.split(' ', 2)
+        if fields[0] == 'error':
+            raise RuntimeError(line)
+        if fields[1] == 'ok':
+            energy, cycles, utilization = fields[2].split()
+            results.append({'success': True, 'energy': float(energy),
+                            'cycles': int(cycles), 'utilization': float(utilization)})
+        else:
+            results.append({'success': False, 'reason': fields[2]})
+    return results
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <csignal>
 #include <cstring>
+#include <thread>
 
 #include "applications/looptree-model/model.hpp"
 #include "compound-config/compound-config.hpp"
@@ -50,6 +51,41 @@ int main(int argc, char* argv[])
 
   auto config = new config::CompoundConfig(input_files);
 
+  auto root = config->getRoot();
+  if (root.exists("mappings"))
+  {
+    // Batch mode: evaluate every mapping of the list in parallel.
+    unsigned num_threads = std::thread::hardware_concurrency();
+    if (root.exists("looptree_model"))
+    {
+      root.lookup("looptree_model").lookupValue("num_threads", num_threads);
+    }
+
+    auto mappings_node = root.lookup("mappings");
+    std::vector<config::CompoundConfigNode> mappings;
+    for (int i = 0; i < mappings_node.getLength(); i++)
+    {
+      mappings.push_back(mappings_node[i]);
+    }
+
+    auto results = application::LooptreeModel::RunBatch(root.lookup("problem"),
+                                                        mappings,
+                                                        num_threads);
+    for (unsigned i = 0; i < results.size(); i++)
+    {
+      std::cout << "mapping " << i << ": "
+                << results[i].n_closed_form_counts << " closed-form counts, "
+                << results[i].n_barvinok_counts << " barvinok counts"
+                << std::endl;
+      for (const auto& [einsum, ops] : results[i].ops)
+      {
+        std::cout << "  einsum " << einsum << " ops: "
+                  << std::get<std::string>(ops) << std::endl;
+      }
+    }
+    return 0;
+  }
+
   application::LooptreeModel application(config);
   
   application.Run();
@@ -47,6 +47,23 @@ LooptreeModel::~LooptreeModel()
 LooptreeModel::Result LooptreeModel::Run()
 {
   Result model_result;
+
+  // Counts box-shaped relations in closed form, barvinok otherwise.
+  auto card = [&model_result](isl_map* p_map)
+  {
+    bool closed_form;
+    auto p_count = isl::map_card(p_map, &closed_form);
+    if (closed_form)
+    {
+      ++model_result.n_closed_form_counts;
+    }
+    else
+    {
+      ++model_result.n_barvinok_counts;
+    }
+    return p_count;
+  };
+
   analysis::MappingAnalysisResult mapping_analysis_result;
   mapping_analysis_result = analysis::OccupanciesFromMapping(mapping_,
                                                              workload_);
@@ -64,36 +81,40 @@ LooptreeModel::Result LooptreeModel::Run()
     const auto einsum_id =
       std::get<mapping::Compute>(mapping_.NodeAt(buf.branch_leaf_id)).kernel;
 
-    auto p_occ_count = isl_map_card(stats.effective_occupancy.map.copy());
+    auto p_occ_count = card(stats.effective_occupancy.map.copy());
     auto key = std::tie(buf.buffer_id, buf.dspace_id, einsum_id);
-    model_result.occupancy[key] = std::make_pair(
+    model_result.occupancy[key] = std::make_tuple(
       stats.effective_occupancy.dim_in_tags,
-      isl_pw_qpolynomial_to_str(p_occ_count)
+      isl_pw_qpolynomial_to_str(p_occ_count),
+      isl::PiecewisePolynomial(p_occ_count)
     );
     isl_pw_qpolynomial_free(p_occ_count);
 
-    auto p_fill_count = isl_map_card(stats.fill.map.copy());
-    model_result.fills[key] = std::make_pair(
+    auto p_fill_count = card(stats.fill.map.copy());
+    model_result.fills[key] = std::make_tuple(
       stats.fill.dim_in_tags,
-      isl_pw_qpolynomial_to_str(p_fill_count)
+      isl_pw_qpolynomial_to_str(p_fill_count),
+      isl::PiecewisePolynomial(p_fill_count)
     );
     isl_pw_qpolynomial_free(p_fill_count);
 
-    auto p_parent_reads_count = isl_map_card(stats.parent_reads.map.copy());
-    model_result.reads_to_parent[key] = std::make_pair(
+    auto p_parent_reads_count = card(stats.parent_reads.map.copy());
+    model_result.reads_to_parent[key] = std::make_tuple(
       stats.parent_reads.dim_in_tags,
-      isl_pw_qpolynomial_to_str(p_parent_reads_count)
+      isl_pw_qpolynomial_to_str(p_parent_reads_count),
+      isl::PiecewisePolynomial(p_parent_reads_count)
     );
     isl_pw_qpolynomial_free(p_parent_reads_count);
 
-    auto p_peer_fills_count = isl_map_card(stats.link_transfer.map.copy());
+    auto p_peer_fills_count = card(stats.link_transfer.map.copy());
     p_peer_fills_count = isl_pw_qpolynomial_intersect_domain(
       p_peer_fills_count,
       stats.fill.map.domain().release()
     );
-    model_result.reads_to_peer[key] = std::make_pair(
+    model_result.reads_to_peer[key] = std::make_tuple(
       stats.link_transfer.dim_in_tags,
-      isl_pw_qpolynomial_to_str(p_peer_fills_count)
+      isl_pw_qpolynomial_to_str(p_peer_fills_count),
+      isl::PiecewisePolynomial(p_peer_fills_count)
     );
     isl_pw_qpolynomial_free(p_peer_fills_count);
   }
@@ -103,10 +124,11 @@ LooptreeModel::Result LooptreeModel::Run()
     const auto& dim_tags = occupancy.dim_in_tags;
     const auto& node =
       std::get<mapping::Compute>(mapping_.NodeAt(lcomp.branch_leaf_id));
-    auto p_ops = isl_map_card(occupancy.map.copy());
-    model_result.ops[node.kernel] = std::make_pair(
+    auto p_ops = card(occupancy.map.copy());
+    model_result.ops[node.kernel] = std::make_tuple(
       dim_tags,
-      isl_pw_qpolynomial_to_str(p_ops)
+      isl_pw_qpolynomial_to_str(p_ops),
+      isl::PiecewisePolynomial(p_ops)
     );
     isl_pw_qpolynomial_free(p_ops);
 
@@ -140,10 +162,11 @@ LooptreeModel::Result LooptreeModel::Run()
       unbounded_identity,
       isl_map_domain(non_spatial_map)
     );
-    const auto temporal_steps = isl_map_card(bounded_identity);
-    model_result.temporal_steps[node.kernel] = std::make_pair(
+    const auto temporal_steps = card(bounded_identity);
+    model_result.temporal_steps[node.kernel] = std::make_tuple(
       new_dim_tags,
-      isl_pw_qpolynomial_to_str(temporal_steps)
+      isl_pw_qpolynomial_to_str(temporal_steps),
+      isl::PiecewisePolynomial(temporal_steps)
     );
     isl_pw_qpolynomial_free(temporal_steps);
   }
@@ -151,4 +174,44 @@ LooptreeModel::Result LooptreeModel::Run()
   return model_result;
 }
 
+std::vector<LooptreeModel::Result> LooptreeModel::RunBatch(
+  config::CompoundConfigNode problem,
+  const std::vector<config::CompoundConfigNode>& mappings,
+  unsigned num_threads
+)
+{
+  // Config nodes share underlying yaml-cpp/libconfig state that is not safe
+  // to read concurrently, so parsing is serialized. Analysis is not.
+  std::mutex parse_mutex;
+
+  IslCtxPool pool(std::min<unsigned>(num_threads, mappings.size()));
+
+  std::vector<std::future<Result>> futures;
+  futures.reserve(mappings.size());
+  for (const auto& mapping_node : mappings)
+  {
+    futures.emplace_back(pool.Submit(
+      [&problem, &mapping_node, &parse_mutex]()
+      {
+        problem::FusedWorkload workload;
+        mapping::FusedMapping mapping;
+        {
+          std::lock_guard<std::mutex> lock(parse_mutex);
+          workload = problem::ParseFusedWorkload(problem);
+          mapping = mapping::ParseMapping(mapping_node, workload);
+        }
+        return LooptreeModel(workload, mapping).Run();
+      }
+    ));
+  }
+
+  std::vector<Result> results;
+  results.reserve(mappings.size());
+  for (auto& future : futures)
+  {
+    results.emplace_back(future.get());
+  }
+  return results;
+}
+
 }
\ No newline at end of file
@@ -101,6 +101,7 @@ int main(int argc, char* argv[])
   const auto fname_to_string = std::map<std::string, const std::string&>({
     {"stats.txt", result.stats_string},
     {"map+stats.xml", result.xml_mapping_stats_string},
+    {"stats.bin", result.columnar_stats_string},
     {"map.txt", result.mapping_string},
     {"map.yaml", result.mapping_yaml_string},
     {"map.cpp", result.mapping_cpp_string},
@@ -110,7 +111,12 @@ int main(int argc, char* argv[])
 
   for (const auto& [fname_suffix, content_string] : fname_to_string)
   {
-    std::ofstream file(out_prefix + "." + fname_suffix);
+    // Formats disabled through mapper.stats_format produce no file.
+    if (content_string.empty() && (fname_suffix == "map+stats.xml" || fname_suffix == "stats.bin"))
+    {
+      continue;
+    }
+    std::ofstream file(out_prefix + "." + fname_suffix, std::ios::binary);
     file << content_string;
     file.close();
   }
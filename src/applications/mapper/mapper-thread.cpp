@@ -25,6 +25,8 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <map>
+#include <sstream>
 #include <ncurses.h>
 
 #include "applications/mapper/mapper-thread.hpp"
@@ -84,11 +86,15 @@ static double Cost(const model::Topology::Stats& stats, const std::string metric
   return cost;
 }
 
+// Relative cost difference below which two mappings are considered equal
+// under a metric.
+static const double betterness_tolerance = 0.001;
+
 static Betterness IsBetterRecursive_(const model::Topology::Stats& candidate, const model::Topology::Stats& incumbent,
                                      const std::vector<std::string>::const_iterator metric,
                                      const std::vector<std::string>::const_iterator end)
 {
-  const double tolerance = 0.001;
+  const double tolerance = betterness_tolerance;
 
   double candidate_cost = Cost(candidate, *metric);
   double incumbent_cost = Cost(incumbent, *metric);
@@ -150,6 +156,25 @@ static inline bool IsEqual(const model::Topology::Stats& candidate, const model:
   return (b == Betterness::SlightlyWorse);
 }
 
+// Bound past which a candidate is Worse than the incumbent under the primary
+// metric, whatever its secondary metrics. Only metrics whose cost grows
+// monotonically while the model evaluates levels can be bounded.
+static model::EvalBound DominationBound(const model::Topology::Stats& incumbent, const std::string& metric)
+{
+  model::EvalBound bound;
+  if (metric == "energy")
+    bound.metric = model::EvalBound::Metric::Energy;
+  else if (metric == "delay")
+    bound.metric = model::EvalBound::Metric::Delay;
+  else if (metric == "edp")
+    bound.metric = model::EvalBound::Metric::EDP;
+  else
+    return bound;
+
+  bound.cost = Cost(incumbent, metric) * (1 + betterness_tolerance);
+  return bound;
+}
+
 bool EvaluationResult::UpdateIfBetter(const EvaluationResult& other, const std::vector<std::string>& metrics)
 {
   bool updated = false;
@@ -286,6 +311,7 @@ MapperThread::MapperThread(
   bool live_status,
   bool diagnostics_on,
   bool penalize_consecutive_bypass_fails,
+  bool branch_and_bound,
   std::vector<std::string> optimization_metrics,
   model::Engine::Specs arch_specs,
   problem::Workload &workload,
@@ -316,6 +342,7 @@ MapperThread::MapperThread(
     live_status_(live_status),
     diagnostics_on_(diagnostics_on),
     penalize_consecutive_bypass_fails_(penalize_consecutive_bypass_fails),
+    branch_and_bound_(branch_and_bound),
     optimization_metrics_(optimization_metrics),
     arch_specs_(arch_specs),
     workload_(workload),
@@ -360,6 +387,13 @@ void MapperThread::Run()
 
   mapspace::ID prev_mapping_id;
 
+  // Capacity pre-check results, keyed by (index factorization, bypass) ID.
+  // The per-level working-set sizes only depend on the tile factors below each
+  // level, not on loop order or spatial X/Y split, so every permutation and
+  // spatial variant of an IF/bypass pair shares one result.
+  std::map<std::pair<uint128_t, uint128_t>, std::vector<model::EvalStatus>> precheck_cache;
+  const std::size_t precheck_cache_capacity = 1 << 16;
+
   // =================
   // Main mapper loop.
   // =================
@@ -473,6 +507,16 @@ void MapperThread::Run()
     // Terminate.
     if (terminate)
     {
+      std::ostringstream search_stats;
+      search_->PrintStats(search_stats);
+      if (!search_stats.str().empty())
+      {
+        mutex_->lock();
+        log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: "
+                    << search_stats.str() << std::endl;
+        mutex_->unlock();
+      }
+
       if (live_status_)
       {
         mutex_->lock();
@@ -507,6 +551,12 @@ void MapperThread::Run()
       }
 
       mutex_->unlock();
+
+      // Let the search prune against another thread's better mapping.
+      if (global_pulled)
+      {
+        search_->UpdateIncumbent(Cost(stats_.thread_best.stats, optimization_metrics_.at(0)));
+      }
     }
 
     //
@@ -577,7 +627,19 @@ void MapperThread::Run()
     //          on, and run some lightweight pre-checks that the
     //          model can use to quickly reject a nest.
     //engine.Spec(arch_specs_);
-    auto status_per_level = engine.PreEvaluationCheck(mapping, workload_, sparse_optimizations_, !diagnostics_on_);
+    auto precheck_key = std::make_pair(mapping_id[int(mapspace::Dimension::IndexFactorization)],
+                                       mapping_id[int(mapspace::Dimension::DatatypeBypass)]);
+    auto precheck = precheck_cache.find(precheck_key);
+    if (precheck == precheck_cache.end())
+    {
+      if (precheck_cache.size() >= precheck_cache_capacity)
+      {
+        precheck_cache.clear();
+      }
+      auto status = engine.PreEvaluationCheck(mapping, workload_, sparse_optimizations_, !diagnostics_on_);
+      precheck = precheck_cache.emplace(precheck_key, std::move(status)).first;
+    }
+    auto status_per_level = precheck->second;
     success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                [](bool cur, const model::EvalStatus& status)
                                { return cur && status.success; });
@@ -603,19 +665,42 @@ void MapperThread::Run()
       continue;
     }
 
-    // Stage 3: Heavyweight evaluation.
+    // Stage 3: Heavyweight evaluation. With branch-and-bound, the model
+    //          gives up on mappings that provably cannot beat thread_best.
+    //          The logging modes that report non-best mappings need them
+    //          fully evaluated.
+    model::EvalBound bound;
+    if (branch_and_bound_ && stats_.thread_best.valid &&
+        !log_all_mappings_ && !log_orojenesis_mappings_ && !log_suboptimal_)
+    {
+      bound = DominationBound(stats_.thread_best.stats, optimization_metrics_.at(0));
+    }
+
     if (layout_initialized_){
-      status_per_level = engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_, !diagnostics_on_);
+      status_per_level = engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_, !diagnostics_on_, bound);
       success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                [](bool cur, const model::EvalStatus& status)
                                { return cur && status.success; });
     }else{
-      status_per_level = engine.Evaluate(mapping, workload_, sparse_optimizations_, !diagnostics_on_);
+      status_per_level = engine.Evaluate(mapping, workload_, sparse_optimizations_, !diagnostics_on_, bound);
       success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                [](bool cur, const model::EvalStatus& status)
                                { return cur && status.success; });
     }
 
+    if (!success && status_per_level.at(0).dominated)
+    {
+      // A mapping that is not better than thread_best. The search can't tell
+      // it apart from a capacity failure, but it still counts towards the
+      // victory condition rather than the timeout.
+      if (penalize_consecutive_bypass_fails_ || !only_bypass_changed)
+      {
+        mappings_since_last_best_update++;
+      }
+      search_->Report(search::Status::EvalFailure);
+      continue;
+    }
+
     if (!success)
     {
       // Evaluation failed.
@@ -112,7 +112,8 @@ Mapper::Mapper(config::CompoundConfig* config,
     // Call accelergy ERT with all input files
     if (arch.exists("subtree") || arch.exists("local"))
     {
-      accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir);
+      accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir,
+                                 config);
       std::string ertPath = out_prefix_ + ".ERT.yaml";
       auto ertConfig = new config::CompoundConfig(ertPath.c_str());
       auto ert = ertConfig->getRoot().lookup("ERT");
@@ -249,9 +250,31 @@ Mapper::Mapper(config::CompoundConfig* config,
   penalize_consecutive_bypass_fails_ = false;
   mapper.lookupValue("penalize_consecutive_bypass_fails", penalize_consecutive_bypass_fails_);
 
+  branch_and_bound_ = false;
+  mapper.lookupValue("branch_and_bound", branch_and_bound_);
+
   emit_whoop_nest_ = false;
   mapper.lookupValue("emit_whoop_nest", emit_whoop_nest_);
 
+  std::string stats_format = "xml";
+  mapper.lookupValue("stats_format", stats_format);
+  if (stats_format != "xml" && stats_format != "columnar" && stats_format != "both")
+  {
+    std::cerr << "ERROR: mapper.stats_format must be one of xml, columnar or both, got "
+              << stats_format << std::endl;
+    exit(1);
+  }
+  xml_stats_ = stats_format != "columnar";
+  columnar_stats_ = stats_format != "xml";
+
+  // Loop permutations with identical reuse are enumerated once unless
+  // expand_permutations is set. Sparse optimizations and layouts can tell
+  // such permutations apart, so they always get all of them.
+  bool expand_permutations = false;
+  mapper.lookupValue("expand_permutations", expand_permutations);
+  bool permutation_classes = !expand_permutations && !rootNode.exists("layout") &&
+                             sparse_optimizations_->no_optimization_applied;
+
   std::cout << "Mapper configuration complete." << std::endl;
 
   // MapSpace configuration.
@@ -288,16 +311,19 @@ Mapper::Mapper(config::CompoundConfig* config,
   // }
 
   bool filter_spatial_fanout = sparse_optimizations_->action_spatial_skipping_info.size() == 0;
-  mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_, filter_spatial_fanout);
+  mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_, filter_spatial_fanout,
+                                          permutation_classes);
   split_mapspaces_ = mapspace_->Split(num_threads_);
 
   std::cout << "Mapspace construction complete." << std::endl;
 
   // Search configuration.
   auto search = rootNode.lookup("mapper");
+  bool dense = sparse_optimizations_->no_optimization_applied;
   for (unsigned t = 0; t < num_threads_; t++)
   {
-    search_.push_back(search::ParseAndConstruct(search, split_mapspaces_.at(t), t));
+    search_.push_back(search::ParseAndConstruct(search, split_mapspaces_.at(t), t,
+                                                optimization_metrics_.at(0), dense));
   }
   std::cout << "Search configuration complete." << std::endl;
   // Store the complete configuration in a string.
@@ -434,6 +460,7 @@ Mapper::Result Mapper::Run()
                                         live_status_,
                                         diagnostics_on_,
                                         penalize_consecutive_bypass_fails_,
+                                        branch_and_bound_,
                                         optimization_metrics_,
                                         arch_specs_,
                                         workload_,
@@ -576,6 +603,7 @@ Mapper::Result Mapper::Run()
   std::stringstream map_cpp_str;
   std::stringstream stats_str;
   std::stringstream xml_map_stats_str;
+  std::stringstream columnar_str;
   std::stringstream tensella_str;
   if (global_best_.valid)
   {
@@ -631,11 +659,22 @@ Mapper::Result Mapper::Run()
     }
 
     // Print the engine stats and mapping to an XML file
-    boost::archive::xml_oarchive ar(xml_map_stats_str);
-    ar << boost::serialization::make_nvp("engine", engine);
-    ar << boost::serialization::make_nvp("mapping", global_best_.mapping);
-    const Mapper* a = this;
-    ar << BOOST_SERIALIZATION_NVP(a);
+    if (xml_stats_)
+    {
+      boost::archive::xml_oarchive ar(xml_map_stats_str);
+      ar << boost::serialization::make_nvp("engine", engine);
+      ar << boost::serialization::make_nvp("mapping", global_best_.mapping);
+      const Mapper* a = this;
+      ar << BOOST_SERIALIZATION_NVP(a);
+    }
+
+    // Print the engine stats in the columnar binary format.
+    if (columnar_stats_)
+    {
+      model::ColumnarStats columnar_stats;
+      engine.GetTopology().ExportStats(columnar_stats);
+      columnar_stats.Write(columnar_str);
+    }
 
     // Print the mapping in Tenssella input format.
     global_best_.mapping.PrintTenssella(tensella_str);
@@ -744,6 +783,7 @@ Mapper::Result Mapper::Run()
   result.stats_string = stats_str.str();
   result.tensella_string = tensella_str.str();
   result.xml_mapping_stats_string = xml_map_stats_str.str();
+  result.columnar_stats_string = columnar_str.str();
   result.orojenesis_string = orojenesis_stream.str();
 
   return result;
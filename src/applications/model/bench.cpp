@@ -0,0 +1,174 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Allocation-counting benchmark for the model hot path. Evaluates the mapping
+// given in the input configs repeatedly on one Engine, the way a mapper
+// thread does, and reports the heap traffic and time per evaluation.
+//
+// Usage is the same as timeloop-model. The number of timed evaluations can be
+// set with model.bench_iterations (default 1000).
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "applications/model/model.hpp"
+#include "compound-config/compound-config.hpp"
+#include "util/args.hpp"
+
+//--------------------------------------------//
+//           Counting global allocator        //
+//--------------------------------------------//
+
+namespace
+{
+
+std::atomic<std::uint64_t> gNumAllocs(0);
+std::atomic<std::uint64_t> gNumBytes(0);
+std::atomic<std::uint64_t> gNumFrees(0);
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  gNumAllocs.fetch_add(1, std::memory_order_relaxed);
+  gNumBytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1))
+  {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  if (p)
+  {
+    gNumFrees.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  operator delete(p);
+}
+
+//--------------------------------------------//
+//                 Benchmark                  //
+//--------------------------------------------//
+
+class ModelBench : public application::Model
+{
+ public:
+  using application::Model::Model;
+
+  void Run(std::uint64_t iterations)
+  {
+    if (!mapping_)
+    {
+      std::cerr << "ERROR: no mapping specified." << std::endl;
+      exit(1);
+    }
+
+    model::Engine engine;
+    SpecEngine(engine);
+
+    auto& mapping = *mapping_;
+    auto evaluate = [&]() { return Evaluate(mapping, engine); };
+
+    // The first evaluation also runs the nest analysis, which is cached for
+    // the identical nests that follow, and sizes any lazily-built state.
+    auto eval_status = evaluate();
+    for (unsigned level = 0; level < eval_status.size(); level++)
+    {
+      if (!eval_status[level].success)
+      {
+        std::cerr << "ERROR: couldn't map level " << level << ": "
+                  << eval_status[level].fail_reason << std::endl;
+        exit(1);
+      }
+    }
+
+    auto allocs_before = gNumAllocs.load();
+    auto bytes_before = gNumBytes.load();
+    auto frees_before = gNumFrees.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::uint64_t i = 0; i < iterations; i++)
+    {
+      evaluate();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double n = double(iterations);
+    double usecs = std::chrono::duration<double, std::micro>(end - start).count();
+
+    std::cout << "Evaluations    = " << iterations << std::endl;
+    std::cout << "Allocs/eval    = " << double(gNumAllocs.load() - allocs_before) / n << std::endl;
+    std::cout << "Frees/eval     = " << double(gNumFrees.load() - frees_before) / n << std::endl;
+    std::cout << "Bytes/eval     = " << double(gNumBytes.load() - bytes_before) / n << std::endl;
+    std::cout << "Time/eval (us) = " << usecs / n << std::endl;
+    std::cout << "Energy (pJ)    = " << engine.Energy() << std::endl;
+    std::cout << "Cycles         = " << engine.Cycles() << std::endl;
+  }
+};
+
+//--------------------------------------------//
+//                    MAIN                    //
+//--------------------------------------------//
+
+int main(int argc, char* argv[])
+{
+  assert(argc >= 2);
+
+  std::vector<std::string> input_files;
+  std::string output_dir = ".";
+  bool success = ParseArgs(argc, argv, input_files, output_dir);
+  if (!success)
+  {
+    std::cerr << "ERROR: error parsing command line." << std::endl;
+    exit(1);
+  }
+
+  auto config = new config::CompoundConfig(input_files);
+
+  unsigned long long iterations = 1000;
+  auto root = config->getRoot();
+  if (root.exists("model"))
+  {
+    root.lookup("model").lookupValue("bench_iterations", iterations);
+  }
+
+  ModelBench bench(config, output_dir, "timeloop-model-bench");
+  bench.Run(iterations);
+
+  return 0;
+}
@@ -28,6 +28,7 @@
 #include <iostream>
 #include <csignal>
 #include <cstring>
+#include <thread>
 
 #include "applications/model/model.hpp"
 #include "compound-config/compound-config.hpp"
@@ -78,22 +79,51 @@ int main(int argc, char* argv[])
   auto config = new config::CompoundConfig(input_files);
 
   application::Model application(config, output_dir);
-  
-  const auto stats = application.Run();
 
   // Output file names.
   std::string out_prefix = output_dir + "/" + "timeloop-model";
 
+  // Batch mode: evaluate a list of mappings against the same problem and
+  // architecture, writing one CSV row per mapping as results come in.
+  auto root = config->getRoot();
+  if (root.exists("mappings"))
+  {
+    unsigned num_threads = std::thread::hardware_concurrency();
+    if (root.exists("model"))
+    {
+      root.lookup("model").lookupValue("num_threads", num_threads);
+    }
+
+    auto mappings_node = root.lookup("mappings");
+    std::vector<config::CompoundConfigNode> mappings;
+    for (int i = 0; i < mappings_node.getLength(); i++)
+    {
+      mappings.push_back(mappings_node[i]);
+    }
+
+    std::ofstream file(out_prefix + ".batch.csv");
+    application.RunBatch(mappings, num_threads, file);
+    return 0;
+  }
+
+  const auto stats = application.Run();
+
   const auto fname_to_string = std::map<std::string, const std::string&>({
     {"stats.txt", stats.stats_string},
     {"map+stats.xml", stats.xml_map_and_stats_string},
+    {"stats.bin", stats.columnar_stats_string},
     {"map.txt", stats.map_string},
     {"map.tensella.txt", stats.tensella_string}
   });
 
   for (const auto& [fname_suffix, content_string] : fname_to_string)
   {
-    std::ofstream file(out_prefix + "." + fname_suffix);
+    // Formats disabled through model.stats_format produce no file.
+    if (content_string.empty() && (fname_suffix == "map+stats.xml" || fname_suffix == "stats.bin"))
+    {
+      continue;
+    }
+    std::ofstream file(out_prefix + "." + fname_suffix, std::ios::binary);
     file << content_string;
     file.close();
   }
@@ -25,7 +25,13 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <mutex>
+#include <thread>
 
 #include "util/accelergy_interface.hpp"
 #include "util/banner.hpp"
@@ -77,6 +83,17 @@ Model::Model(config::CompoundConfig* config,
     model.lookupValue("verbose", verbose_);
     model.lookupValue("auto_bypass_on_failure", auto_bypass_on_failure_);
     model.lookupValue("out_prefix", semi_qualified_prefix);
+
+    std::string stats_format = "xml";
+    model.lookupValue("stats_format", stats_format);
+    if (stats_format != "xml" && stats_format != "columnar" && stats_format != "both")
+    {
+      std::cerr << "ERROR: model.stats_format must be one of xml, columnar or both, got "
+                << stats_format << std::endl;
+      exit(1);
+    }
+    xml_stats_ = stats_format != "columnar";
+    columnar_stats_ = stats_format != "xml";
   }
 
   out_prefix_ = output_dir + "/" + semi_qualified_prefix;
@@ -127,7 +144,8 @@ Model::Model(config::CompoundConfig* config,
     // Call accelergy ERT with all input files
     if (arch.exists("subtree") || arch.exists("local"))
     {
-      accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir);
+      accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir,
+                                 config);
       std::string ertPath = out_prefix_ + ".ERT.yaml";
       auto ertConfig = new config::CompoundConfig(ertPath.c_str());
       auto ert = ertConfig->getRoot().lookup("ERT");
@@ -173,17 +191,29 @@ Model::Model(config::CompoundConfig* config,
   if (verbose_)
     std::cout << "Architecture configuration complete." << std::endl;
 
-  // Mapping configuration: expressed as a mapspace or mapping.
-  auto mapping = rootNode.lookup("mapping");
-  mapping_ = new Mapping(mapping::ParseAndConstruct(mapping, arch_specs_, workload_));
-  if (verbose_)
-    std::cout << "Mapping construction complete." << std::endl;
-
-  // Validate mapping against the architecture constraints.
-  if (!constraints_->SatisfiedBy(mapping_))
+  // Mapping configuration: expressed as a mapspace or mapping. Server and
+  // batch inputs carry their mappings separately.
+  if (rootNode.exists("mapping"))
   {
-    std::cerr << "ERROR: mapping violates architecture constraints." << std::endl;
-    exit(1);
+    auto mapping = rootNode.lookup("mapping");
+    try
+    {
+      mapping_ = new Mapping(mapping::ParseAndConstruct(mapping, arch_specs_, workload_));
+    }
+    catch (const std::runtime_error& e)
+    {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      exit(1);
+    }
+    if (verbose_)
+      std::cout << "Mapping construction complete." << std::endl;
+
+    // Validate mapping against the architecture constraints.
+    if (!constraints_->SatisfiedBy(mapping_))
+    {
+      std::cerr << "ERROR: mapping violates architecture constraints." << std::endl;
+      exit(1);
+    }
   }
 
   // layout modeling
@@ -227,59 +257,27 @@ Model::~Model()
 // Run the evaluation.
 Model::Stats Model::Run()
 {
+  if (!mapping_)
+  {
+    std::cerr << "ERROR: no mapping specified." << std::endl;
+    exit(1);
+  }
+
   model::Engine engine;
-  engine.Spec(arch_specs_);
+  SpecEngine(engine);
 
   auto level_names = arch_specs_.topology.LevelNames();
 
   auto& mapping = *mapping_;
-    
-  // Optional feature: if the given mapping does not fit in the available
-  // hardware resources, automatically bypass storage level(s) to make it
-  // fit. This avoids mapping failures and instead substitutes the given
-  // mapping with one that fits but is higher cost and likely sub-optimal.
-  // *However*, this only covers capacity failures due to temporal factors,
-  // not instance failures due to spatial factors. It also possibly
-  // over-corrects since it bypasses *all* data_spaces at a failing level,
-  // while it's possible that bypassing a subset of data_spaces may have
-  // caused the mapping to fit.
-  if (auto_bypass_on_failure_)
+
+  auto eval_status = Evaluate(mapping, engine);
+  for (unsigned level = 0; level < eval_status.size(); level++)
   {
-    auto pre_eval_status = engine.PreEvaluationCheck(mapping, workload_, sparse_optimizations_, false);
-    for (unsigned level = 0; level < pre_eval_status.size(); level++)
-      if (!pre_eval_status[level].success)
-      {
-        if (verbose_)
-          std::cerr << "WARNING: couldn't map level " << level_names.at(level) << ": "
-                    << pre_eval_status[level].fail_reason << ", auto-bypassing."
-                    << std::endl;
-        for (unsigned pvi = 0; pvi < workload_.GetShape()->NumDataSpaces; pvi++)
-          // Ugh... mask is offset-by-1 because level 0 is the arithmetic level.
-          mapping.datatype_bypass_nest.at(pvi).reset(level-1);
-      }
-  }
-  
-  if (layout_initialized_){ 
-    auto eval_status = engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_);
-    for (unsigned level = 0; level < eval_status.size(); level++)
+    if (!eval_status[level].success)
     {
-      if (!eval_status[level].success)
-      {
-        std::cerr << "ERROR: couldn't map level " << level_names.at(level) << ": "
-                  << eval_status[level].fail_reason << std::endl;
-        exit(1);
-      }
-    }
-  }else{
-    auto eval_status = engine.Evaluate(mapping, workload_, sparse_optimizations_);    
-    for (unsigned level = 0; level < eval_status.size(); level++)
-    {
-      if (!eval_status[level].success)
-      {
-        std::cerr << "ERROR: couldn't map level " << level_names.at(level) << ": "
-                  << eval_status[level].fail_reason << std::endl;
-        exit(1);
-      }
+      std::cerr << "ERROR: couldn't map level " << level_names.at(level) << ": "
+                << eval_status[level].fail_reason << std::endl;
+      exit(1);
     }
   }
 
@@ -322,11 +320,23 @@ Model::Stats Model::Run()
 
   // Print the engine stats and mapping to an XML file
   std::stringstream xml_str;
-  boost::archive::xml_oarchive ar(xml_str);
-  ar << BOOST_SERIALIZATION_NVP(engine);
-  ar << BOOST_SERIALIZATION_NVP(mapping);
-  const Model* a = this;
-  ar << BOOST_SERIALIZATION_NVP(a);
+  if (xml_stats_)
+  {
+    boost::archive::xml_oarchive ar(xml_str);
+    ar << BOOST_SERIALIZATION_NVP(engine);
+    ar << BOOST_SERIALIZATION_NVP(mapping);
+    const Model* a = this;
+    ar << BOOST_SERIALIZATION_NVP(a);
+  }
+
+  // Print the engine stats in the columnar binary format.
+  std::stringstream columnar_str;
+  if (columnar_stats_)
+  {
+    model::ColumnarStats columnar_stats;
+    engine.GetTopology().ExportStats(columnar_stats);
+    columnar_stats.Write(columnar_str);
+  }
 
   // Print the mapping in Tenssella input format.
   std::stringstream tenssella_out;
@@ -336,6 +346,7 @@ Model::Stats Model::Run()
   stats.map_string = map_txt.str();
   stats.stats_string = stats_txt.str();
   stats.xml_map_and_stats_string = xml_str.str();
+  stats.columnar_stats_string = columnar_str.str();
   stats.tensella_string = tenssella_out.str();
 
   stats.cycles = engine.Cycles();
@@ -343,4 +354,152 @@ Model::Stats Model::Run()
   return stats;
 }
 
+void Model::RunBatch(const std::vector<config::CompoundConfigNode>& mapping_configs,
+                     unsigned num_threads, std::ostream& out)
+{
+  auto level_names = arch_specs_.topology.LevelNames();
+  auto num_mappings = mapping_configs.size();
+
+  // Parsing walks the config tree, which is not safe to share across
+  // threads, so all mappings are parsed up front.
+  std::vector<Mapping> mappings(num_mappings);
+  std::vector<std::string> rows(num_mappings);
+  std::vector<bool> parsed(num_mappings);
+  for (unsigned i = 0; i < num_mappings; i++)
+  {
+    std::string fail_reason;
+    parsed[i] = ParseMapping(mapping_configs[i], mappings[i], fail_reason);
+    if (!parsed[i])
+    {
+      std::replace(fail_reason.begin(), fail_reason.end(), ',', ';');
+      std::replace(fail_reason.begin(), fail_reason.end(), '\n', ' ');
+      rows[i] = std::to_string(i) + ",fail,,,,," + fail_reason;
+    }
+  }
+
+  out << "index,status,energy_pJ,cycles,utilization,pJ_per_compute,fail_reason" << std::endl;
+
+  std::mutex out_mutex;
+  std::vector<bool> done(num_mappings);
+  unsigned next_to_write = 0;
+  std::atomic<unsigned> next(0);
+
+  auto worker = [&]()
+  {
+    model::Engine engine;
+    SpecEngine(engine);
+
+    for (unsigned i = next++; i < num_mappings; i = next++)
+    {
+      if (parsed[i])
+      {
+        auto eval_status = Evaluate(mappings[i], engine);
+        std::ostringstream row;
+        row << std::setprecision(std::numeric_limits<double>::max_digits10) << i;
+
+        unsigned failed_level = eval_status.size();
+        for (unsigned level = 0; level < eval_status.size() && failed_level == eval_status.size(); level++)
+          if (!eval_status[level].success)
+            failed_level = level;
+
+        if (failed_level == eval_status.size())
+        {
+          row << ",ok," << engine.Energy() << "," << engine.Cycles() << ","
+              << engine.Utilization() << ","
+              << engine.Energy() / engine.GetTopology().ActualComputes() << ",";
+        }
+        else
+        {
+          std::string reason = level_names.at(failed_level) + ": " + eval_status[failed_level].fail_reason;
+          std::replace(reason.begin(), reason.end(), ',', ';');
+          std::replace(reason.begin(), reason.end(), '\n', ' ');
+          row << ",fail,,,,," << reason;
+        }
+        rows[i] = row.str();
+      }
+
+      std::lock_guard<std::mutex> lock(out_mutex);
+      done[i] = true;
+      while (next_to_write < num_mappings && done[next_to_write])
+      {
+        out << rows[next_to_write] << std::endl;
+        rows[next_to_write].clear();
+        next_to_write++;
+      }
+    }
+  };
+
+  num_threads = std::max(1u, std::min<unsigned>(num_threads, num_mappings));
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < num_threads; t++)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+}
+
+bool Model::ParseMapping(config::CompoundConfigNode mapping_config, Mapping& mapping,
+                         std::string& fail_reason)
+{
+  // A malformed mapping fails on its own instead of ending the batch.
+  try
+  {
+    mapping = mapping::ParseAndConstruct(mapping_config, arch_specs_, workload_);
+  }
+  catch (const std::exception& e)
+  {
+    fail_reason = e.what();
+    return false;
+  }
+  if (!constraints_->SatisfiedBy(&mapping))
+  {
+    fail_reason = "mapping violates architecture constraints";
+    return false;
+  }
+  return true;
+}
+
+void Model::SpecEngine(model::Engine& engine) const
+{
+  engine.Spec(arch_specs_);
+}
+
+std::vector<model::EvalStatus> Model::Evaluate(Mapping& mapping, model::Engine& engine)
+{
+  // Optional feature: if the given mapping does not fit in the available
+  // hardware resources, automatically bypass storage level(s) to make it
+  // fit. This avoids mapping failures and instead substitutes the given
+  // mapping with one that fits but is higher cost and likely sub-optimal.
+  // *However*, this only covers capacity failures due to temporal factors,
+  // not instance failures due to spatial factors. It also possibly
+  // over-corrects since it bypasses *all* data_spaces at a failing level,
+  // while it's possible that bypassing a subset of data_spaces may have
+  // caused the mapping to fit.
+  if (auto_bypass_on_failure_)
+  {
+    auto level_names = arch_specs_.topology.LevelNames();
+    auto pre_eval_status = engine.PreEvaluationCheck(mapping, workload_, sparse_optimizations_, false);
+    for (unsigned level = 0; level < pre_eval_status.size(); level++)
+      if (!pre_eval_status[level].success)
+      {
+        if (verbose_)
+          std::cerr << "WARNING: couldn't map level " << level_names.at(level) << ": "
+                    << pre_eval_status[level].fail_reason << ", auto-bypassing."
+                    << std::endl;
+        for (unsigned pvi = 0; pvi < workload_.GetShape()->NumDataSpaces; pvi++)
+          // Ugh... mask is offset-by-1 because level 0 is the arithmetic level.
+          mapping.datatype_bypass_nest.at(pvi).reset(level-1);
+      }
+  }
+
+  if (layout_initialized_)
+    return engine.Evaluate(mapping, workload_, layout_, sparse_optimizations_);
+  else
+    return engine.Evaluate(mapping, workload_, sparse_optimizations_);
+}
+
 } // namespace application
@@ -0,0 +1,538 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Long-lived timeloop-model evaluation server.
+//
+//   timeloop-model-server <socket-path> [num-threads]
+//
+// Listens on a Unix domain socket. Every message in either direction is
+// framed as "<payload-bytes>\n<payload>". A request is a YAML document in the
+// timeloop-model input format, with either a single `mapping` or a list of
+// `mappings`. Everything except the mappings (problem, architecture, ERT/ART,
+// sparse optimizations, constraints, layout) is parsed once and kept for as
+// long as consecutive requests carry identical content. The mappings of a
+// request are evaluated concurrently, one engine per thread, and the
+// response holds one line per mapping, in order:
+//
+//   <index> ok <energy-pJ> <cycles> <utilization>
+//   <index> fail <reason>
+//
+// A request that cannot be parsed gets a single "error <reason>" line, as
+// does a request whose length header exceeds kMaxRequestBytes (the
+// connection is then closed, since the stream can't be resynchronized).
+//
+// Much of the model reports bad input by calling exit(), so requests are
+// evaluated in a worker process forked from the server. If the worker exits
+// while handling a request, that request gets an error and the next one
+// starts a fresh worker (which parses its context again).
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "applications/model/model.hpp"
+#include "compound-config/compound-config.hpp"
+
+//--------------------------------------------//
+//                  Framing                   //
+//--------------------------------------------//
+
+namespace
+{
+
+bool ReadFully(int fd, char* buf, std::size_t len)
+{
+  while (len > 0)
+  {
+    auto n = read(fd, buf, len);
+    if (n <= 0)
+    {
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+bool WriteFully(int fd, const char* buf, std::size_t len)
+{
+  while (len > 0)
+  {
+    auto n = write(fd, buf, len);
+    if (n <= 0)
+    {
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+// Requests larger than this are rejected before anything is allocated.
+const std::size_t kMaxRequestBytes = std::size_t(1) << 30;
+
+enum class ReadStatus
+{
+  Ok,
+  Closed,
+  Malformed,
+  TooLarge
+};
+
+ReadStatus ReadMessage(int fd, std::string& message,
+                       std::size_t max_len = std::numeric_limits<std::size_t>::max())
+{
+  std::size_t len = 0;
+  bool too_large = false;
+  char c;
+  while (true)
+  {
+    if (!ReadFully(fd, &c, 1))
+    {
+      return ReadStatus::Closed;
+    }
+    if (c == '\n')
+    {
+      break;
+    }
+    if (c < '0' || c > '9')
+    {
+      return ReadStatus::Malformed;
+    }
+    // Keep consuming the header, but stop accumulating once it can't fit.
+    too_large |= len > (max_len - (c - '0')) / 10;
+    if (!too_large)
+    {
+      len = 10 * len + (c - '0');
+    }
+  }
+  if (too_large)
+  {
+    return ReadStatus::TooLarge;
+  }
+
+  message.resize(len);
+  return ReadFully(fd, message.data(), len) ? ReadStatus::Ok : ReadStatus::Closed;
+}
+
+bool WriteMessage(int fd, const std::string& message)
+{
+  auto header = std::to_string(message.size()) + "\n";
+  return WriteFully(fd, header.data(), header.size()) &&
+         WriteFully(fd, message.data(), message.size());
+}
+
+// Everything in a request that the parsed model depends on, as one string.
+std::string ContextString(config::CompoundConfig& config)
+{
+  std::string context;
+  for (const auto& entry : config.getYConfig())
+  {
+    auto key = entry.first.as<std::string>();
+    if (key == "mapping" || key == "mappings")
+    {
+      continue;
+    }
+    context += key;
+    context += YAML::Dump(entry.second);
+  }
+  return context;
+}
+
+std::string OneLine(std::string text)
+{
+  std::replace(text.begin(), text.end(), '\n', ' ');
+  return text;
+}
+
+} // namespace
+
+//--------------------------------------------//
+//                   Server                   //
+//--------------------------------------------//
+
+class ModelServer
+{
+ private:
+  unsigned num_threads_;
+
+  // The model parsed from the most recent request context. Only one
+  // problem::Workload can be alive at a time, so a new context replaces the
+  // old one rather than being cached next to it. The hash only speeds up
+  // the comparison; a hit is confirmed against the full context string.
+  std::size_t context_hash_ = 0;
+  std::string context_;
+  std::unique_ptr<config::CompoundConfig> context_config_;
+  std::unique_ptr<application::Model> model_;
+  std::vector<std::unique_ptr<model::Engine>> engines_;
+
+  void LoadContext(std::unique_ptr<config::CompoundConfig> config, std::string context, std::size_t hash)
+  {
+    engines_.clear();
+    model_.reset();
+    context_.clear();
+    context_config_ = std::move(config);
+    model_ = std::make_unique<application::Model>(context_config_.get(), ".", "timeloop-model-server");
+    context_hash_ = hash;
+    context_ = std::move(context);
+
+    for (unsigned t = 0; t < num_threads_; t++)
+    {
+      engines_.push_back(std::make_unique<model::Engine>());
+      model_->SpecEngine(*engines_.back());
+    }
+  }
+
+ public:
+  ModelServer(unsigned num_threads) :
+      num_threads_(num_threads)
+  {
+  }
+
+  std::string Handle(const std::string& request)
+  {
+    std::vector<config::CompoundConfigNode> mapping_configs;
+    std::unique_ptr<config::CompoundConfig> config;
+    try
+    {
+      config = std::make_unique<config::CompoundConfig>(request, "yaml");
+      auto root = config->getRoot();
+      if (root.exists("mappings"))
+      {
+        auto mappings = root.lookup("mappings");
+        for (int i = 0; i < mappings.getLength(); i++)
+        {
+          mapping_configs.push_back(mappings[i]);
+        }
+      }
+      else if (root.exists("mapping"))
+      {
+        mapping_configs.push_back(root.lookup("mapping"));
+        // Keep the Model constructor from parsing (and exiting on) it.
+        config->getYConfig().remove("mapping");
+      }
+    }
+    catch (std::exception& e)
+    {
+      return "error " + OneLine(e.what()) + "\n";
+    }
+
+    // Keep the request's config alive for its mapping nodes; it becomes the
+    // context config if the context changed.
+    auto context = ContextString(*config);
+    auto hash = std::hash<std::string>{}(context);
+    std::unique_ptr<config::CompoundConfig> request_config;
+    if (model_ && hash == context_hash_ && context == context_)
+    {
+      request_config = std::move(config);
+    }
+    else
+    {
+      try
+      {
+        LoadContext(std::move(config), std::move(context), hash);
+      }
+      catch (std::exception& e)
+      {
+        engines_.clear();
+        model_.reset();
+        context_config_.reset();
+        return "error " + OneLine(e.what()) + "\n";
+      }
+    }
+
+    // Mapping parsing walks the config, so it stays on this thread.
+    auto level_names = model_->GetArchSpecs().topology.LevelNames();
+    std::vector<Mapping> mappings(mapping_configs.size());
+    std::vector<std::string> results(mapping_configs.size());
+    std::vector<bool> parsed(mapping_configs.size());
+    for (unsigned i = 0; i < mapping_configs.size(); i++)
+    {
+      std::string fail_reason;
+      try
+      {
+        parsed[i] = model_->ParseMapping(mapping_configs[i], mappings[i], fail_reason);
+      }
+      catch (std::exception& e)
+      {
+        fail_reason = OneLine(e.what());
+      }
+      if (!parsed[i])
+      {
+        results[i] = std::to_string(i) + " fail " + fail_reason;
+      }
+    }
+
+    std::atomic<unsigned> next(0);
+    auto worker = [&](model::Engine& engine)
+    {
+      for (unsigned i = next++; i < mappings.size(); i = next++)
+      {
+        if (!parsed[i])
+        {
+          continue;
+        }
+
+        auto eval_status = model_->Evaluate(mappings[i], engine);
+        std::ostringstream result;
+        result << std::setprecision(std::numeric_limits<double>::max_digits10) << i;
+        bool success = true;
+        for (unsigned level = 0; level < eval_status.size(); level++)
+        {
+          if (!eval_status[level].success)
+          {
+            result << " fail " << level_names.at(level) << ": "
+                   << OneLine(eval_status[level].fail_reason);
+            success = false;
+            break;
+          }
+        }
+        if (success)
+        {
+          result << " ok " << engine.Energy() << " " << engine.Cycles()
+                 << " " << engine.Utilization();
+        }
+        results[i] = result.str();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < engines_.size(); t++)
+    {
+      threads.emplace_back(worker, std::ref(*engines_[t]));
+    }
+    worker(*engines_[0]);
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    std::string response;
+    for (auto& result : results)
+    {
+      response += result;
+      response += "\n";
+    }
+    return response;
+  }
+};
+
+//--------------------------------------------//
+//               Worker Process               //
+//--------------------------------------------//
+
+// A ModelServer in a child process, connected to the server by a socket
+// pair over which it receives requests and returns responses with the
+// same framing as clients use.
+class WorkerProcess
+{
+ private:
+  unsigned num_threads_;
+  pid_t pid_ = -1;
+  int fd_ = -1;
+
+  bool Start()
+  {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+      return false;
+    }
+
+    pid_ = fork();
+    if (pid_ < 0)
+    {
+      close(fds[0]);
+      close(fds[1]);
+      return false;
+    }
+
+    if (pid_ == 0)
+    {
+      close(fds[0]);
+      ModelServer server(num_threads_);
+      std::string request;
+      while (ReadMessage(fds[1], request) == ReadStatus::Ok)
+      {
+        if (!WriteMessage(fds[1], server.Handle(request)))
+        {
+          break;
+        }
+      }
+      _exit(0);
+    }
+
+    close(fds[1]);
+    fd_ = fds[0];
+    return true;
+  }
+
+  // Reaps the worker and describes how it ended.
+  std::string Stop()
+  {
+    close(fd_);
+    fd_ = -1;
+
+    int status = 0;
+    std::string reason = "evaluation process ended";
+    if (waitpid(pid_, &status, 0) == pid_)
+    {
+      if (WIFEXITED(status))
+      {
+        reason = "evaluation process exited with status " + std::to_string(WEXITSTATUS(status));
+      }
+      else if (WIFSIGNALED(status))
+      {
+        reason = "evaluation process killed by signal " + std::to_string(WTERMSIG(status));
+      }
+    }
+    pid_ = -1;
+    return reason;
+  }
+
+ public:
+  WorkerProcess(unsigned num_threads) :
+      num_threads_(num_threads)
+  {
+  }
+
+  ~WorkerProcess()
+  {
+    if (pid_ > 0)
+    {
+      Stop();
+    }
+  }
+
+  std::string Handle(const std::string& request)
+  {
+    if (pid_ < 0 && !Start())
+    {
+      return "error cannot start evaluation process: " + std::string(strerror(errno)) + "\n";
+    }
+
+    std::string response;
+    if (!WriteMessage(fd_, request) || ReadMessage(fd_, response) != ReadStatus::Ok)
+    {
+      return "error " + Stop() + "\n";
+    }
+    return response;
+  }
+};
+
+//--------------------------------------------//
+//                    MAIN                    //
+//--------------------------------------------//
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <socket-path> [num-threads]" << std::endl;
+    return 1;
+  }
+
+  std::string socket_path = argv[1];
+  unsigned num_threads = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+  num_threads = std::max(num_threads, 1u);
+
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path))
+  {
+    std::cerr << "ERROR: socket path too long: " << socket_path << std::endl;
+    return 1;
+  }
+  std::strcpy(addr.sun_path, socket_path.c_str());
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(socket_path.c_str());
+  if (listen_fd < 0 ||
+      bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(listen_fd, 16) != 0)
+  {
+    std::cerr << "ERROR: cannot listen on " << socket_path << ": "
+              << strerror(errno) << std::endl;
+    return 1;
+  }
+
+  // A client that disconnects mid-response must not kill the server.
+  signal(SIGPIPE, SIG_IGN);
+
+  std::cout << "Listening on " << socket_path << " with " << num_threads
+            << " threads." << std::endl;
+
+  WorkerProcess worker(num_threads);
+
+  // Clients are served one at a time; each request is parallel internally.
+  while (true)
+  {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0)
+    {
+      continue;
+    }
+
+    std::string request;
+    while (true)
+    {
+      auto status = ReadMessage(fd, request, kMaxRequestBytes);
+      if (status == ReadStatus::TooLarge)
+      {
+        WriteMessage(fd, "error request exceeds " + std::to_string(kMaxRequestBytes) + " bytes\n");
+      }
+      else if (status == ReadStatus::Malformed)
+      {
+        WriteMessage(fd, "error malformed message header\n");
+      }
+      if (status != ReadStatus::Ok || !WriteMessage(fd, worker.Handle(request)))
+      {
+        break;
+      }
+    }
+    close(fd);
+  }
+
+  return 0;
+}
@@ -65,7 +65,7 @@ Application::Application(config::CompoundConfig* config)
 #ifdef USE_ACCELERGY
   if (arch.exists("subtree") || arch.exists("local"))
   {
-    accelergy::invokeAccelergy(config->inFiles, out_prefix_, ".");
+    accelergy::invokeAccelergy(config->inFiles, out_prefix_, ".", config);
     std::string ertPath = out_prefix_ + ".ERT.yaml";
     auto ertConfig = new config::CompoundConfig(ertPath.c_str());
     auto ert = ertConfig->getRoot().lookup("ERT");
@@ -1,5 +1,6 @@
 #include "isl-wrapper/ctx-manager.hpp"
 
+#include <algorithm>
 #include <optional>
 
 /******************************************************************************
@@ -25,4 +26,74 @@ isl::ctx& GetIslCtx()
 std::mutex& GetIslMutex()
 {
   return gIslMutex;
-}
\ No newline at end of file
+}
+
+void ReleaseIslCtx()
+{
+  if (gCtx)
+  {
+    isl_ctx_free(gCtx->get());
+    gCtx.reset();
+  }
+}
+
+void ResetIslCtx()
+{
+  ReleaseIslCtx();
+}
+
+/******************************************************************************
+ * IslCtxPool
+ *****************************************************************************/
+
+IslCtxPool::IslCtxPool(unsigned num_workers, unsigned jobs_per_reset) :
+    jobs_per_reset_(std::max(jobs_per_reset, 1U))
+{
+  num_workers = std::max(num_workers, 1U);
+  for (unsigned i = 0; i < num_workers; i++)
+  {
+    workers_.emplace_back(&IslCtxPool::WorkerLoop, this);
+  }
+}
+
+IslCtxPool::~IslCtxPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+void IslCtxPool::WorkerLoop()
+{
+  unsigned jobs_since_reset = 0;
+  while (true)
+  {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty())
+      {
+        break;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop();
+    }
+
+    // Exceptions are captured in the job's future by packaged_task.
+    job();
+
+    if (++jobs_since_reset == jobs_per_reset_)
+    {
+      ResetIslCtx();
+      jobs_since_reset = 0;
+    }
+  }
+  ReleaseIslCtx();
+}
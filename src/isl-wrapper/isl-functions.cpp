@@ -2,6 +2,7 @@
 
 #include "barvinok/isl.h"
 #include "isl/constraint.h"
+#include "isl/fixed_box.h"
 
 #include "isl-wrapper/ctx-manager.hpp"
 #include "isl-wrapper/isl-functions.hpp"
@@ -304,6 +305,72 @@ isl_pw_qpolynomial* sum_map_range_card(isl::map map)
   return isl_set_apply_pw_qpolynomial(p_domain, p_count);
 }
 
+isl_pw_qpolynomial* box_map_card(isl_map* p_map)
+{
+  auto p_box = isl_map_get_range_simple_fixed_box_hull(p_map);
+  if (isl_fixed_box_is_valid(p_box) != isl_bool_true)
+  {
+    isl_fixed_box_free(p_box);
+    return nullptr;
+  }
+
+  auto p_offset = isl_fixed_box_get_offset(p_box);
+  auto p_size = isl_fixed_box_get_size(p_box);
+  isl_fixed_box_free(p_box);
+
+  // Rebuild { d -> offset(d) + k : 0 <= k < size } and check it against the
+  // original map. The hull is only an overapproximation otherwise.
+  auto p_domain = isl_map_domain(isl_map_copy(p_map));
+  auto p_deltas = isl_set_universe(isl_space_range(isl_map_get_space(p_map)));
+  auto p_volume = isl_val_one(isl_map_get_ctx(p_map));
+  auto n_dims = isl_multi_val_size(p_size);
+  for (isl_size i = 0; i < n_dims; ++i)
+  {
+    auto p_dim_size = isl_multi_val_get_val(p_size, i);
+    p_deltas = isl_set_lower_bound_si(p_deltas, isl_dim_set, i, 0);
+    p_deltas = isl_set_upper_bound_val(
+      p_deltas, isl_dim_set, i, isl_val_sub_ui(isl_val_copy(p_dim_size), 1)
+    );
+    p_volume = isl_val_mul(p_volume, p_dim_size);
+  }
+  isl_multi_val_free(p_size);
+
+  auto p_box_map = isl_map_sum(
+    isl_map_intersect_domain(isl_map_from_multi_aff(p_offset),
+                             isl_set_copy(p_domain)),
+    isl_map_from_domain_and_range(isl_set_copy(p_domain), p_deltas)
+  );
+  auto is_box = isl_map_is_equal(p_box_map, p_map);
+  isl_map_free(p_box_map);
+
+  if (is_box != isl_bool_true)
+  {
+    isl_set_free(p_domain);
+    isl_val_free(p_volume);
+    return nullptr;
+  }
+
+  auto p_qp = isl_qpolynomial_val_on_domain(isl_set_get_space(p_domain),
+                                            p_volume);
+  return isl_pw_qpolynomial_alloc(p_domain, p_qp);
+}
+
+isl_pw_qpolynomial* map_card(isl_map* p_map, bool* closed_form)
+{
+  auto p_count = box_map_card(p_map);
+  if (closed_form)
+  {
+    *closed_form = p_count != nullptr;
+  }
+
+  if (p_count)
+  {
+    isl_map_free(p_map);
+    return p_count;
+  }
+  return isl_map_card(p_map);
+}
+
 isl_pw_qpolynomial* set_card(isl::set set)
 {
   return isl_set_card(set.release());
@@ -0,0 +1,308 @@
+#include <numeric>
+#include <stdexcept>
+
+#include <isl/aff.h>
+#include <isl/constraint.h>
+#include <isl/local_space.h>
+#include <isl/set.h>
+#include <isl/space.h>
+#include <isl/val.h>
+
+#include "isl-wrapper/piecewise-polynomial.hpp"
+
+namespace isl {
+
+/******************************************************************************
+ * Local declarations
+ *****************************************************************************/
+
+namespace
+{
+
+long ValToLong(__isl_take isl_val* p_val)
+{
+  if (!isl_val_is_int(p_val))
+  {
+    isl_val_free(p_val);
+    throw std::logic_error("PiecewisePolynomial: unexpected rational value");
+  }
+  auto result = isl_val_get_num_si(p_val);
+  isl_val_free(p_val);
+  return result;
+}
+
+long FloorDiv(long num, long denom)
+{
+  auto quot = num / denom;
+  return (num % denom != 0 && ((num < 0) != (denom < 0))) ? quot - 1 : quot;
+}
+
+// Reads the floor argument of a local variable, scaled to integers.
+PiecewisePolynomial::Div DivFromAff(__isl_take isl_aff* p_aff)
+{
+  PiecewisePolynomial::Div div;
+  auto p_denom = isl_aff_get_denominator_val(p_aff);
+  div.denom = ValToLong(isl_val_copy(p_denom));
+
+  auto scaled = [&](__isl_take isl_val* p_coef)
+  {
+    return ValToLong(isl_val_mul(p_coef, isl_val_copy(p_denom)));
+  };
+
+  for (auto type : {isl_dim_param, isl_dim_in, isl_dim_div})
+  {
+    auto n = isl_aff_dim(p_aff, type);
+    for (isl_size i = 0; i < n; ++i)
+    {
+      div.expr.coefs.push_back(
+        scaled(isl_aff_get_coefficient_val(p_aff, type, i))
+      );
+    }
+  }
+  div.expr.constant = scaled(isl_aff_get_constant_val(p_aff));
+
+  // The aff spans all locals of its space, but a local only depends on the
+  // ones before it; drop the zeros so it can be evaluated in order.
+  while (!div.expr.coefs.empty() && div.expr.coefs.back() == 0)
+  {
+    div.expr.coefs.pop_back();
+  }
+
+  isl_val_free(p_denom);
+  isl_aff_free(p_aff);
+  return div;
+}
+
+}  // namespace
+
+/******************************************************************************
+ * PiecewisePolynomial
+ *****************************************************************************/
+
+long PiecewisePolynomial::Affine::Eval(const std::vector<long>& vars) const
+{
+  long result = constant;
+  for (size_t i = 0; i < coefs.size(); ++i)
+  {
+    result += coefs[i] * vars[i];
+  }
+  return result;
+}
+
+PiecewisePolynomial::PiecewisePolynomial(isl_pw_qpolynomial* p_pwqp)
+{
+  auto p_space = isl_pw_qpolynomial_get_domain_space(p_pwqp);
+  auto n_params = isl_space_dim(p_space, isl_dim_param);
+  for (isl_size i = 0; i < n_params; ++i)
+  {
+    auto name = isl_space_get_dim_name(p_space, isl_dim_param, i);
+    param_names_.emplace_back(name ? name : "");
+  }
+  n_dims_ = isl_space_dim(p_space, isl_dim_set);
+  isl_space_free(p_space);
+
+  isl_pw_qpolynomial_foreach_piece(
+    p_pwqp,
+    [](__isl_take isl_set* p_set, __isl_take isl_qpolynomial* p_qp, void* user)
+    {
+      auto& pieces = *static_cast<std::vector<Piece>*>(user);
+      auto& piece = pieces.emplace_back();
+
+      isl_set_foreach_basic_set(
+        p_set,
+        [](__isl_take isl_basic_set* p_bset, void* user)
+        {
+          auto& domain = *static_cast<std::vector<BasicSet>*>(user);
+          auto& bset = domain.emplace_back();
+
+          auto p_ls = isl_basic_set_get_local_space(p_bset);
+          auto n_divs = isl_local_space_dim(p_ls, isl_dim_div);
+          for (isl_size i = 0; i < n_divs; ++i)
+          {
+            bset.divs.emplace_back(DivFromAff(isl_local_space_get_div(p_ls, i)));
+          }
+          isl_local_space_free(p_ls);
+
+          isl_basic_set_foreach_constraint(
+            p_bset,
+            [](__isl_take isl_constraint* p_c, void* user)
+            {
+              auto& bset = *static_cast<BasicSet*>(user);
+              Affine expr;
+              for (auto type : {isl_dim_param, isl_dim_set, isl_dim_div})
+              {
+                auto n = isl_constraint_dim(p_c, type);
+                for (isl_size i = 0; i < n; ++i)
+                {
+                  expr.coefs.push_back(ValToLong(
+                    isl_constraint_get_coefficient_val(p_c, type, i)
+                  ));
+                }
+              }
+              expr.constant = ValToLong(isl_constraint_get_constant_val(p_c));
+
+              if (isl_constraint_is_equality(p_c))
+              {
+                bset.eqs.emplace_back(std::move(expr));
+              }
+              else
+              {
+                bset.ineqs.emplace_back(std::move(expr));
+              }
+              isl_constraint_free(p_c);
+              return isl_stat_ok;
+            },
+            static_cast<void*>(&bset)
+          );
+
+          isl_basic_set_free(p_bset);
+          return isl_stat_ok;
+        },
+        static_cast<void*>(&piece.domain)
+      );
+      isl_set_free(p_set);
+
+      // Terms of a qpolynomial share its locals, so they are read once. The
+      // coefficients are kept as numerators over a common denominator.
+      std::vector<std::pair<long, long>> coefs;
+      struct TermsState { Piece* piece; std::vector<std::pair<long, long>>* coefs; };
+      TermsState state{&piece, &coefs};
+      isl_qpolynomial_foreach_term(
+        p_qp,
+        [](__isl_take isl_term* p_term, void* user)
+        {
+          auto& state = *static_cast<TermsState*>(user);
+          auto& piece = *state.piece;
+
+          auto n_divs = isl_term_dim(p_term, isl_dim_div);
+          if (piece.terms.empty())
+          {
+            for (isl_size i = 0; i < n_divs; ++i)
+            {
+              piece.divs.emplace_back(DivFromAff(isl_term_get_div(p_term, i)));
+            }
+          }
+
+          Term term;
+          for (auto type : {isl_dim_param, isl_dim_set, isl_dim_div})
+          {
+            auto n = isl_term_dim(p_term, type);
+            for (isl_size i = 0; i < n; ++i)
+            {
+              term.exps.push_back(isl_term_get_exp(p_term, type, i));
+            }
+          }
+
+          auto p_coef = isl_term_get_coefficient_val(p_term);
+          state.coefs->emplace_back(isl_val_get_num_si(p_coef),
+                                    isl_val_get_den_si(p_coef));
+          isl_val_free(p_coef);
+          isl_term_free(p_term);
+
+          piece.terms.emplace_back(std::move(term));
+          return isl_stat_ok;
+        },
+        static_cast<void*>(&state)
+      );
+      isl_qpolynomial_free(p_qp);
+
+      for (const auto& [num, den] : coefs)
+      {
+        piece.denom = std::lcm(piece.denom, den);
+      }
+      for (size_t i = 0; i < coefs.size(); ++i)
+      {
+        piece.terms[i].coef = coefs[i].first * (piece.denom / coefs[i].second);
+      }
+
+      return isl_stat_ok;
+    },
+    static_cast<void*>(&pieces_)
+  );
+}
+
+double PiecewisePolynomial::Evaluate(const std::vector<long>& params,
+                                     const std::vector<long>& dims) const
+{
+  if (params.size() != param_names_.size() || dims.size() != n_dims_)
+  {
+    throw std::invalid_argument("PiecewisePolynomial: wrong number of values");
+  }
+
+  std::vector<long> vars(params);
+  vars.insert(vars.end(), dims.begin(), dims.end());
+  const auto n_vars = vars.size();
+
+  auto with_locals = [&vars, n_vars](const std::vector<Div>& divs)
+  {
+    vars.resize(n_vars);
+    for (const auto& div : divs)
+    {
+      vars.push_back(FloorDiv(div.expr.Eval(vars), div.denom));
+    }
+  };
+
+  for (const auto& piece : pieces_)
+  {
+    bool in_domain = false;
+    for (const auto& bset : piece.domain)
+    {
+      with_locals(bset.divs);
+      in_domain = true;
+      for (const auto& eq : bset.eqs)
+      {
+        in_domain = in_domain && eq.Eval(vars) == 0;
+      }
+      for (const auto& ineq : bset.ineqs)
+      {
+        in_domain = in_domain && ineq.Eval(vars) >= 0;
+      }
+      if (in_domain)
+      {
+        break;
+      }
+    }
+    if (!in_domain)
+    {
+      continue;
+    }
+
+    with_locals(piece.divs);
+    __int128 sum = 0;
+    for (const auto& term : piece.terms)
+    {
+      __int128 monomial = term.coef;
+      for (size_t i = 0; i < term.exps.size(); ++i)
+      {
+        for (unsigned e = 0; e < term.exps[i]; ++e)
+        {
+          monomial *= vars[i];
+        }
+      }
+      sum += monomial;
+    }
+    return static_cast<double>(sum) / piece.denom;
+  }
+
+  return 0;
+}
+
+double PiecewisePolynomial::EvaluateNamed(
+  const std::map<std::string, long>& params,
+  const std::vector<long>& dims) const
+{
+  std::vector<long> param_values;
+  param_values.reserve(param_names_.size());
+  for (const auto& name : param_names_)
+  {
+    auto it = params.find(name);
+    if (it == params.end())
+    {
+      throw std::invalid_argument("PiecewisePolynomial: no value for " + name);
+    }
+    param_values.push_back(it->second);
+  }
+  return Evaluate(param_values, dims);
+}
+
+};  // namespace isl
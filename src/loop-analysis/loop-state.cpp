@@ -25,11 +25,77 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
 #include "loop-analysis/loop-state.hpp"
 
 namespace analysis
 {
 
+// ---------------------------------------------------------------
+// Compact copy of the deltas sent to the children of a spatial level.
+// ---------------------------------------------------------------
+
+void SpatialDeltaCorners::Assign(const std::unordered_map<std::uint64_t, problem::OperationSpace>& deltas,
+                                 std::uint64_t num_children, unsigned num_data_spaces)
+{
+  num_data_spaces_ = num_data_spaces;
+  auto num_entries = num_children * num_data_spaces;
+  offsets_.assign(num_entries + 1, 0);
+  empty_.assign(num_entries, true);
+  corners_.clear();
+
+  // Children are visited in id order so that each run ends where the next
+  // one begins.
+  for (std::uint64_t child = 0; child < num_children; child++)
+  {
+    auto delta = deltas.find(child);
+    for (unsigned pv = 0; pv < num_data_spaces; pv++)
+    {
+      auto entry = child * num_data_spaces + pv;
+      offsets_[entry] = corners_.size();
+      if (delta != deltas.end() && !delta->second.IsEmpty(pv))
+      {
+        empty_[entry] = false;
+        delta->second.AppendCorners(pv, corners_);
+      }
+    }
+  }
+  offsets_[num_entries] = corners_.size();
+}
+
+void SpatialDeltaCorners::clear()
+{
+  num_data_spaces_ = 0;
+  offsets_.clear();
+  empty_.clear();
+  corners_.clear();
+}
+
+bool SpatialDeltaCorners::IsEmpty(std::uint64_t child, unsigned pv) const
+{
+  auto entry = child * num_data_spaces_ + pv;
+  return entry >= empty_.size() || empty_[entry];
+}
+
+bool SpatialDeltaCorners::Equals(std::uint64_t child, const SpatialDeltaCorners& other,
+                                 std::uint64_t other_child, unsigned pv) const
+{
+  auto entry = child * num_data_spaces_ + pv;
+  auto other_entry = other_child * other.num_data_spaces_ + pv;
+  if (entry >= empty_.size() || other_entry >= other.empty_.size() ||
+      empty_[entry] != other.empty_[other_entry])
+  {
+    return false;
+  }
+
+  auto begin = corners_.begin() + offsets_[entry];
+  auto end = corners_.begin() + offsets_[entry + 1];
+  auto other_begin = other.corners_.begin() + other.offsets_[other_entry];
+  auto other_end = other.corners_.begin() + other.offsets_[other_entry + 1];
+  return std::equal(begin, end, other_begin, other_end);
+}
+
 // ---------------------------------------------------------------
 // Live state for a single spatial element in a single loop level.
 // ---------------------------------------------------------------
@@ -23,7 +23,8 @@ namespace analysis
  * Local declarations
  *****************************************************************************/
 
-BranchTilings TilingFromMapping(const loop::Nest& nest);
+BranchTilings TilingFromMapping(const loop::Nest& nest,
+                                const SymbolicBounds& symbolic_bounds);
 
 std::vector<std::pair<LogicalBuffer, size_t>> 
 BufferIterLevelsFromMapping(const loop::Nest& nest,
@@ -31,7 +32,8 @@ BufferIterLevelsFromMapping(const loop::Nest& nest,
 
 std::map<LogicalBuffer, Skew>
 LogicalBufSkewsFromMapping(const loop::Nest& mapping,
-                           const problem::Workload& workload);
+                           const problem::Workload& workload,
+                           const SymbolicBounds& symbolic_bounds);
 
 std::map<DataSpaceId, isl::map>
 OpsToDSpaceFromEinsum(const problem::Workload& workload);
@@ -42,11 +44,13 @@ OpsToDSpaceFromEinsum(const problem::Workload& workload);
 
 std::map<LogicalBuffer, Occupancy>
 OccupanciesFromMapping(const loop::Nest& mapping,
-                       const problem::Workload& workload)
+                       const problem::Workload& workload,
+                       const SymbolicBounds& symbolic_bounds)
 {
   auto ops_to_dspace = OpsToDSpaceFromEinsum(workload);
-  auto branch_tiling = TilingFromMapping(mapping).at(0);
-  auto buf_skew = LogicalBufSkewsFromMapping(mapping, workload);
+  auto branch_tiling = TilingFromMapping(mapping, symbolic_bounds).at(0);
+  auto buf_skew = LogicalBufSkewsFromMapping(mapping, workload,
+                                             symbolic_bounds);
 
   std::map<LogicalBuffer, Occupancy> result;
   for (auto& [buf, skew] : buf_skew)
@@ -66,13 +70,51 @@ OccupanciesFromMapping(const loop::Nest& mapping,
   return result;
 }
 
+SymbolicBounds
+OutermostSymbolicBounds(const loop::Nest& mapping,
+                        const problem::Workload& workload)
+{
+  const auto& loops = mapping.loops;
+  const auto& dim_names = workload.GetShape()->FlattenedDimensionIDToName;
+
+  SymbolicBounds result;
+  std::set<problem::Shape::FlattenedDimensionID> seen_dims;
+  for (std::size_t i = loops.size(); i-- > 0; )
+  {
+    const auto& loop = loops.at(i);
+    if (!seen_dims.insert(loop.dimension).second)
+    {
+      continue;
+    }
+    if (loop.spacetime_dimension == spacetime::Dimension::Time
+        && (loop.residual_end == 0 || loop.residual_end == loop.end))
+    {
+      result.emplace(i, dim_names.at(loop.dimension) + "_" + std::to_string(i));
+    }
+  }
+  return result;
+}
+
+std::map<std::string, long>
+SymbolicBoundValues(const loop::Nest& mapping,
+                    const SymbolicBounds& symbolic_bounds)
+{
+  std::map<std::string, long> result;
+  for (const auto& [loop_idx, name] : symbolic_bounds)
+  {
+    result.emplace(name, mapping.loops.at(loop_idx).end);
+  }
+  return result;
+}
+
 
 /******************************************************************************
  * Local function implementations
  *****************************************************************************/
 
 BranchTilings
-TilingFromMapping(const loop::Nest& nest)
+TilingFromMapping(const loop::Nest& nest,
+                  const SymbolicBounds& symbolic_bounds)
 {
   const auto& loops = nest.loops;
 
@@ -82,6 +124,41 @@ TilingFromMapping(const loop::Nest& nest)
     ospace_dims.insert(loop.dimension);
   }
 
+  // Symbolic bounds are parameters of the iteration space.
+  auto iter_space = isl::space_set_alloc(GetIslCtx(),
+                                         symbolic_bounds.size(),
+                                         loops.size());
+  unsigned param_idx = 0;
+  for (const auto& [loop_idx, name] : symbolic_bounds)
+  {
+    const auto& loop = loops.at(loop_idx);
+    for (auto k = loop_idx + 1; k < loops.size(); ++k)
+    {
+      if (loops.at(k).dimension == loop.dimension)
+      {
+        throw std::logic_error("symbolic bound " + name
+                               + " is not the outermost loop of its dimension");
+      }
+    }
+    if (loop.residual_end > 0 && loop.residual_end != loop.end)
+    {
+      throw std::logic_error("symbolic bound " + name
+                             + " is imperfectly factorized");
+    }
+    iter_space = isl::manage(isl_space_set_dim_name(iter_space.release(),
+                                                    isl_dim_param,
+                                                    param_idx++,
+                                                    name.c_str()));
+  }
+
+  // Every loop runs at least once.
+  auto p_iter_context = isl_set_universe(iter_space.copy());
+  for (unsigned i = 0; i < param_idx; ++i)
+  {
+    p_iter_context = isl_set_lower_bound_si(p_iter_context, isl_dim_param, i, 1);
+  }
+  const auto iter_context = isl::manage(p_iter_context);
+
   isl_map* p_tiling = nullptr;
   for (auto ospace_dim : ospace_dims)
   {
@@ -111,17 +188,11 @@ TilingFromMapping(const loop::Nest& nest)
 
     const auto n_iter_dims = loops.size();
     isl_map* p_cur_ospace_dim_tiling = nullptr;
-    auto identity = isl::multi_aff::identity_on_domain(
-      isl::space_set_alloc(GetIslCtx(), 0, n_iter_dims)
-    );
+    auto identity = isl::multi_aff::identity_on_domain(iter_space);
     for (unsigned i = 0; i < coefs.size(); ++i)
     {
-      auto iter_set = isl::set::universe(
-        isl::space_set_alloc(GetIslCtx(), 0, n_iter_dims)
-      );
-      auto aff = isl::aff::zero_on_domain(
-        isl::space_set_alloc(GetIslCtx(), 0, loops.size())
-      );
+      auto iter_set = iter_context;
+      auto aff = isl::aff::zero_on_domain(iter_space);
 
       unsigned j = 0;
       for (unsigned k = 0; k < loops.size(); ++k)
@@ -137,7 +208,26 @@ TilingFromMapping(const loop::Nest& nest)
         const auto size = sizes.at(j);
         const auto residual = residuals.at(j);
         const auto identity_k = identity.get_at(reversed_iter_dim);
-        const auto last_iter_coord = residual - 1;
+
+        // residual + offset, with the residual possibly a parameter.
+        const auto symbolic_it = symbolic_bounds.find(k);
+        auto bound = [&](int offset)
+        {
+          if (symbolic_it == symbolic_bounds.end())
+          {
+            return isl::si_on_domain(identity.space().domain(),
+                                     residual + offset);
+          }
+          return isl::manage(isl_aff_add_constant_si(
+            isl_aff_param_on_domain_space_id(
+              identity.space().domain().release(),
+              isl_id_alloc(GetIslCtx().get(),
+                           symbolic_it->second.c_str(),
+                           nullptr)
+            ),
+            offset
+          ));
+        };
 
         aff = isl::set_coefficient_si(aff, isl_dim_in, reversed_iter_dim, coef);
 
@@ -157,28 +247,20 @@ TilingFromMapping(const loop::Nest& nest)
             iter_set = iter_set.intersect(identity_k.ge_set(
                 isl::si_on_domain(identity.space().domain(), 0)
             ));
-            iter_set = iter_set.intersect(identity_k.lt_set(
-                isl::si_on_domain(identity.space().domain(), residual)
-            ));
+            iter_set = iter_set.intersect(identity_k.lt_set(bound(0)));
           }
           else
           {
             iter_set = iter_set.intersect(identity_k.ge_set(
                 isl::si_on_domain(identity.space().domain(), 0)
             ));
-            iter_set = iter_set.intersect(identity_k.lt_set(
-                isl::si_on_domain(identity.space().domain(), residual-1)
-            ));
+            iter_set = iter_set.intersect(identity_k.lt_set(bound(-1)));
           }
         }
         else
         {
-          iter_set = iter_set.intersect(identity_k.ge_set(
-              isl::si_on_domain(identity.space().domain(), last_iter_coord)
-          ));
-          iter_set = iter_set.intersect(identity_k.le_set(
-              isl::si_on_domain(identity.space().domain(), last_iter_coord)
-          ));
+          iter_set = iter_set.intersect(identity_k.ge_set(bound(-1)));
+          iter_set = iter_set.intersect(identity_k.le_set(bound(-1)));
         }
         ++j;
       }
@@ -259,7 +341,8 @@ BufferIterLevelsFromMapping(const loop::Nest& nest,
 
 std::map<LogicalBuffer, Skew>
 LogicalBufSkewsFromMapping(const loop::Nest& nest,  
-                           const problem::Workload& workload)
+                           const problem::Workload& workload,
+                           const SymbolicBounds& symbolic_bounds)
 {
   const auto& loops = nest.loops;
   const auto n_loops = loops.size();
@@ -345,6 +428,14 @@ LogicalBufSkewsFromMapping(const loop::Nest& nest,
       }
       p_aff = isl_aff_list_get_aff(p_aff_list, aff_list_size-1);
 
+      if (last_x_idx_opt
+          && symbolic_bounds.find(timeloop_loop_idx) != symbolic_bounds.end())
+      {
+        throw std::logic_error("symbolic bound "
+                               + symbolic_bounds.at(timeloop_loop_idx)
+                               + " scales an outer spatial loop");
+      }
+
       auto last_x_idx = last_x_idx_opt.value_or(loop_idx);
       unsigned long tile_size = loop_it->end - loop_it->start;
       for (auto i = last_x_idx; i < loop_idx; ++i)
@@ -383,6 +474,14 @@ LogicalBufSkewsFromMapping(const loop::Nest& nest,
       }
       p_aff = isl_aff_list_get_aff(p_aff_list, aff_list_size-1);
 
+      if (last_y_idx_opt
+          && symbolic_bounds.find(timeloop_loop_idx) != symbolic_bounds.end())
+      {
+        throw std::logic_error("symbolic bound "
+                               + symbolic_bounds.at(timeloop_loop_idx)
+                               + " scales an outer spatial loop");
+      }
+
       auto last_y_idx = last_y_idx_opt.value_or(loop_idx);
       unsigned long tile_size = loop_it->end - loop_it->start;
       for (int i = last_y_idx; i < loop_idx; ++i)
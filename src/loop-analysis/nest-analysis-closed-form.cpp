@@ -0,0 +1,431 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Closed-form nest analysis.
+//
+// ComputeDeltas() walks the nest, building point sets for iterations #0, #1
+// (and sometimes #last) of every level and subtracting each tile from the
+// previous one. For the common dense case (no flattening, no skew, perfect
+// factorization, unit-stride loops from 0) in which every data-space rank is
+// indexed by at most one looped dimension, the outcome of that walk has a
+// closed form: two tiles of a level are either identical or disjoint, so each
+// delta is either empty or the whole tile. The tile held at a level changes
+// whenever a relevant loop above it advances, so the number of fills is the
+// product of the temporal loop bounds above it, from the innermost relevant
+// non-unit one outwards. Spatial children that share their relevant spatial
+// indices receive the same deltas, which fixes the multicast groups.
+//
+// The results are written into the same per-level live state that the
+// recursive walk fills in, so CollectWorkingSets() builds the output nests
+// for both. The walk keeps one entry per sampled spatial instance and
+// CollectWorkingSets() reports their average; here every instance of a level
+// sees the same tiles and the same traffic, so a single entry holding the
+// per-instance values yields the same average.
+//
+// Set TIMELOOP_DISABLE_CLOSED_FORM_ANALYSIS to always walk, and
+// TIMELOOP_CHECK_CLOSED_FORM_ANALYSIS to also run the walk and report any
+// difference.
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "loop-analysis/nest-analysis.hpp"
+
+extern bool gEnableClosedFormAnalysis;
+extern bool gEnableLinkTransfers;
+extern bool gEnableToroidalLinks;
+extern bool gEnableTracing;
+
+namespace analysis
+{
+
+bool NestAnalysis::ClosedFormApplicable() const
+{
+  auto shape = workload_->GetShape();
+
+  if (!gEnableClosedFormAnalysis || shape->UsesFlattening || imperfectly_factorized_ ||
+      gEnableTracing || !skew_descriptors_.empty())
+  {
+    return false;
+  }
+
+  for (auto& loop : nest_state_)
+  {
+    if (loop.descriptor.start != 0 || loop.descriptor.stride != 1)
+    {
+      return false;
+    }
+  }
+
+  // The children of a spatial fanout must each own a storage tile, or they
+  // share the subtrahend of their deltas.
+  for (unsigned level = 0; level < nest_state_.size(); level++)
+  {
+    if (master_spatial_level_[level])
+    {
+      unsigned innermost = level;
+      while (innermost > 0 && loop::IsSpatial(nest_state_[innermost-1].descriptor.spacetime_dimension))
+      {
+        innermost--;
+      }
+      if (innermost > 0 && !storage_boundary_level_[innermost-1])
+      {
+        return false;
+      }
+    }
+  }
+
+  // Every rank must be indexed by at most one dimension that is actually
+  // looped over, so that tiles along a loop never overlap.
+  auto& full_tile = mold_high_.back();
+  for (unsigned pvi = 0; pvi < shape->NumDataSpaces; pvi++)
+  {
+    for (auto& expression : shape->Projections.at(pvi))
+    {
+      unsigned num_looped_terms = 0;
+      for (auto& term : expression)
+      {
+        int coefficient = term.first == shape->NumCoefficients ? 1 : workload_->GetCoefficient(term.first);
+        auto dim = shape->FactorizedToFlattened.at(term.second);
+        if (coefficient != 0 && full_tile[dim] > 0)
+        {
+          num_looped_terms++;
+        }
+      }
+      if (num_looped_terms > 1)
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+void NestAnalysis::ComputeClosedFormDeltas()
+{
+  auto shape = workload_->GetShape();
+  unsigned num_levels = nest_state_.size();
+  unsigned num_data_spaces = shape->NumDataSpaces;
+
+  // Dimensions each data space's projection depends on.
+  std::vector<std::vector<bool>> relevant(num_data_spaces,
+                                          std::vector<bool>(shape->NumFlattenedDimensions, false));
+  for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+  {
+    for (auto& expression : shape->Projections.at(pvi))
+    {
+      for (auto& term : expression)
+      {
+        if (term.first == shape->NumCoefficients || workload_->GetCoefficient(term.first) != 0)
+        {
+          relevant[pvi][shape->FactorizedToFlattened.at(term.second)] = true;
+        }
+      }
+    }
+  }
+
+  // Tile sizes at every level. Every invocation of a level sees the same
+  // tile shape.
+  std::vector<problem::PerDataSpace<std::size_t>> tile_sizes;
+  problem::OperationPoint origin;
+  for (unsigned level = 0; level < num_levels; level++)
+  {
+    tile_sizes.push_back(problem::OperationSpace(workload_, origin, mold_high_[level]).GetSizes());
+  }
+
+  // Number of times each level is invoked, per instance of its storage tile:
+  // the product of all temporal loop bounds above it.
+  std::vector<std::uint64_t> invocations(num_levels, 1);
+  for (int level = int(num_levels) - 2; level >= 0; level--)
+  {
+    auto& outer = nest_state_[level+1].descriptor;
+    invocations[level] = invocations[level+1] *
+      (loop::IsSpatial(outer.spacetime_dimension) ? 1 : outer.end);
+  }
+  std::uint64_t temporal_iterations = invocations[0];
+  if (!loop::IsSpatial(nest_state_[0].descriptor.spacetime_dimension))
+  {
+    temporal_iterations *= nest_state_[0].descriptor.end;
+  }
+
+  // Number of distinct consecutive tiles a level holds for a data space,
+  // i.e., the number of non-empty deltas it returns.
+  auto Fills = [&](unsigned level, unsigned pv)
+  {
+    std::uint64_t fills = 1;
+    bool changes = false;
+    for (unsigned outer = level + 1; outer < num_levels; outer++)
+    {
+      auto& descriptor = nest_state_[outer].descriptor;
+      if (loop::IsSpatial(descriptor.spacetime_dimension))
+      {
+        continue;
+      }
+      changes |= (descriptor.end > 1 && relevant[pv][descriptor.dimension]);
+      if (changes)
+      {
+        fills *= descriptor.end;
+      }
+    }
+    return fills;
+  };
+
+  auto IsSet = [&](const std::unordered_map<unsigned, problem::PerDataSpace<bool>>& flags,
+                   unsigned level, unsigned pv)
+  {
+    auto it = flags.find(arch_storage_level_[level]);
+    return it != flags.end() && it->second[pv];
+  };
+
+  // Adds count copies of the stats of one invocation.
+  auto Accumulate = [](AccessStatMatrix& total, const AccessStatMatrix& one, std::uint64_t count)
+  {
+    for (auto& x : one.stats)
+    {
+      auto& stats = total(x.first.first, x.first.second);
+      stats.accesses += x.second.accesses * count;
+      stats.hops += x.second.hops * count;
+      stats.unicast_hops += x.second.unicast_hops * count;
+    }
+  };
+
+  compute_info_[std::vector<unsigned>()].accesses = temporal_iterations;
+
+  for (unsigned level = 0; level < num_levels; level++)
+  {
+    auto& cur = nest_state_[level];
+    bool spatial = loop::IsSpatial(cur.descriptor.spacetime_dimension);
+    if (spatial && !master_spatial_level_[level])
+    {
+      continue;
+    }
+
+    // One entry stands for every spatial instance of this level (see above).
+    auto& cur_state = cur.live_state.emplace(std::vector<unsigned>(), ElementState(*workload_)).first->second;
+
+    if (storage_boundary_level_[level] || master_spatial_level_[level])
+    {
+      for (unsigned pv = 0; pv < num_data_spaces; pv++)
+      {
+        cur_state.max_size[pv] = tile_sizes[level][pv];
+      }
+    }
+
+    if (!spatial)
+    {
+      if (level == 0 || storage_boundary_level_[level-1])
+      {
+        for (unsigned pv = 0; pv < num_data_spaces; pv++)
+        {
+          auto& access_stats = cur_state.access_stats[pv](1, 1);
+          if (level == 0)
+          {
+            access_stats.accesses += temporal_iterations;
+          }
+          else
+          {
+            auto deltas = IsSet(no_temporal_reuse_, level-1, pv) ? invocations[level-1] : Fills(level-1, pv);
+            access_stats.accesses += tile_sizes[level-1][pv] * deltas;
+          }
+          access_stats.hops = 0.0;
+          access_stats.unicast_hops = 0.0;
+        }
+      }
+      continue;
+    }
+
+    //
+    // Master spatial level: the fanout spans this loop down to the innermost
+    // consecutive spatial loop.
+    //
+    unsigned innermost = level;
+    while (innermost > 0 && loop::IsSpatial(nest_state_[innermost-1].descriptor.spacetime_dimension))
+    {
+      innermost--;
+    }
+
+    std::uint64_t num_elems = logical_fanouts_[level];
+    auto h_size = std::max(physical_fanoutX_.at(arch_storage_level_.at(level)), logical_fanoutX_[level]);
+    auto v_size = std::max(physical_fanoutY_.at(arch_storage_level_.at(level)), logical_fanoutY_[level]);
+
+    // Per data space, the key of each child: its indices in the relevant
+    // spatial loops. Children with equal keys receive equal deltas. Child ids
+    // are mixed-radix with the outermost loop most significant, as in
+    // FillSpatialDeltas().
+    std::vector<std::vector<std::uint64_t>> keys(num_data_spaces, std::vector<std::uint64_t>(num_elems, 0));
+    for (std::uint64_t id = 0; id < num_elems; id++)
+    {
+      std::uint64_t remainder = id;
+      std::vector<std::uint64_t> radix(num_data_spaces, 1);
+      for (unsigned l = innermost; l <= level; l++)
+      {
+        auto& descriptor = nest_state_[l].descriptor;
+        std::uint64_t index = remainder % descriptor.end;
+        remainder /= descriptor.end;
+        for (unsigned pv = 0; pv < num_data_spaces; pv++)
+        {
+          if (relevant[pv][descriptor.dimension])
+          {
+            keys[pv][id] += index * radix[pv];
+            radix[pv] *= descriptor.end;
+          }
+        }
+      }
+    }
+
+    // Stats for one invocation in which every included child receives a
+    // delta of the given size.
+    auto MulticastStats = [&](const std::vector<std::uint64_t>& key, const std::vector<bool>& included,
+                              std::size_t delta_size)
+    {
+      std::map<std::uint64_t, std::vector<std::uint64_t>> groups;
+      for (std::uint64_t id = 0; id < num_elems; id++)
+      {
+        if (included[id])
+        {
+          groups[key[id]].push_back(id);
+        }
+      }
+
+      struct TempAccessStats
+      {
+        double accesses = 0;
+        std::uint64_t scatter_factor = 0;
+        double hops = 0.0;
+        double unicast_hops = 0.0;
+      };
+      std::map<std::uint64_t, TempAccessStats> temp_stats;
+      for (auto& group : groups)
+      {
+        auto& temp_struct = temp_stats[group.second.size()];
+        temp_struct.accesses += delta_size;
+        temp_struct.scatter_factor++;
+
+        double hops, unicast_hops;
+        MulticastHops(group.second, h_size, v_size, hops, unicast_hops);
+        temp_struct.hops += hops;
+        temp_struct.unicast_hops += unicast_hops;
+      }
+
+      AccessStatMatrix stats;
+      for (auto& x : temp_stats)
+      {
+        auto scatter = x.second.scatter_factor;
+        stats(x.first, scatter) =
+          { x.second.accesses,
+            (x.second.hops * x.second.accesses) / scatter,
+            (x.second.unicast_hops * x.second.accesses) / scatter };
+      }
+      return stats;
+    };
+
+    bool links = gEnableLinkTransfers && linked_spatial_level_[level];
+    std::vector<std::uint64_t> ids(num_elems);
+    for (std::uint64_t id = 0; id < num_elems; id++)
+    {
+      ids[id] = id;
+    }
+
+    for (unsigned pv = 0; pv < num_data_spaces; pv++)
+    {
+      // The innermost spatial loop either feeds compute directly, in which case
+      // every child receives its operand point on every invocation, or feeds
+      // a storage tile.
+      bool child_is_point = (innermost == 0);
+      std::size_t delta_size = child_is_point ? 1 : tile_sizes[innermost-1][pv];
+      bool always_full = child_is_point || IsSet(no_temporal_reuse_, innermost-1, pv);
+
+      auto& multicast_key = IsSet(no_multicast_, level, pv) ? ids : keys[pv];
+      std::vector<bool> all(num_elems, true);
+      auto without_links = MulticastStats(multicast_key, all, delta_size);
+
+      // Invocations in which the relevant temporal indices advanced (and the
+      // first one): the deltas are new to every child and to its neighbors.
+      auto fills = Fills(level, pv);
+      Accumulate(cur_state.access_stats[pv], without_links, fills);
+
+      // The remaining invocations only deliver deltas if the child cannot
+      // retain them. Each child then needs what it needed in the previous
+      // invocation, which a neighbor holding the same data can forward.
+      if (!always_full || invocations[level] == fills)
+      {
+        continue;
+      }
+      auto repeats = invocations[level] - fills;
+
+      std::vector<bool> needs_parent(num_elems, true);
+      std::uint64_t num_forwarded = 0;
+      if (links && !IsSet(no_link_transfer_, level, pv))
+      {
+        for (std::uint64_t id = 0; id < num_elems; id++)
+        {
+          std::uint64_t h_id = id % h_size;
+          std::uint64_t v_id = id / h_size;
+          std::vector<std::uint64_t> neighbors;
+          if (v_size > 1)
+          {
+            if (gEnableToroidalLinks || v_id > 0)
+              neighbors.push_back(((v_id + v_size - 1) % v_size) * h_size + h_id);
+            if (gEnableToroidalLinks || v_id < v_size - 1)
+              neighbors.push_back(((v_id + 1) % v_size) * h_size + h_id);
+          }
+          if (h_size > 1)
+          {
+            if (gEnableToroidalLinks || h_id > 0)
+              neighbors.push_back(v_id * h_size + (h_id + h_size - 1) % h_size);
+            if (gEnableToroidalLinks || h_id < h_size - 1)
+              neighbors.push_back(v_id * h_size + (h_id + 1) % h_size);
+          }
+          for (auto neighbor : neighbors)
+          {
+            if (neighbor < num_elems && keys[pv][neighbor] == keys[pv][id])
+            {
+              needs_parent[id] = false;
+              num_forwarded++;
+              break;
+            }
+          }
+        }
+      }
+
+      auto with_links = MulticastStats(multicast_key, needs_parent, delta_size);
+      if (num_forwarded > 0 && with_links.TotalAccesses() < without_links.TotalAccesses())
+      {
+        Accumulate(cur_state.access_stats[pv], with_links, repeats);
+        cur_state.link_transfers[pv] += num_forwarded * delta_size * repeats;
+      }
+      else
+      {
+        Accumulate(cur_state.access_stats[pv], without_links, repeats);
+      }
+    }
+  }
+}
+
+} // namespace analysis
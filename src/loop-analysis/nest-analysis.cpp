@@ -26,6 +26,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <stdexcept>
 #include <unordered_map>
@@ -85,6 +86,12 @@ bool gUseIslAnalysis =
 bool gPrintNestAnalysisResult =
   (getenv("TIMELOOP_PRINT_NEST_ANALYSIS_RESULT") != NULL) &&
   (strcmp(getenv("TIMELOOP_PRINT_NEST_ANALYSIS_RESULT"), "0") != 0);
+bool gEnableClosedFormAnalysis =
+  (getenv("TIMELOOP_DISABLE_CLOSED_FORM_ANALYSIS") == NULL) ||
+  (strcmp(getenv("TIMELOOP_DISABLE_CLOSED_FORM_ANALYSIS"), "0") == 0);
+bool gCheckClosedFormAnalysis =
+  (getenv("TIMELOOP_CHECK_CLOSED_FORM_ANALYSIS") != NULL) &&
+  (strcmp(getenv("TIMELOOP_CHECK_CLOSED_FORM_ANALYSIS"), "0") != 0);
 
 
 // Flattening => Multi-AAHRs
@@ -106,7 +113,7 @@ NestAnalysis::NestAnalysis()
 
 
 
-void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest, layout::Layouts layout,
+void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest, const layout::Layouts& layout,
                         std::map<unsigned, std::uint64_t> fanoutX_map,
                         std::map<unsigned, std::uint64_t> fanoutY_map)
 {
@@ -120,7 +127,7 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest, layout::L
   layout_ = layout;
   layout_initialized_ = true;
 
-  if (working_sets_computed_ && cached_nest == *nest)
+  if (nest_initialized_ && cached_nest == *nest)
   {
     // We've already worked on an identical nest before.
   }
@@ -159,6 +166,7 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest, layout::L
     // Properly size working_sets_ by re-constructing it based on now-available
     // parsed workload information.
     working_sets_ = decltype(working_sets_)(workload_->GetShape()->NumDataSpaces);
+    nest_initialized_ = true;
   }
 
   gResetOnStrideChange = !workload_->GetShape()->UsesFlattening; 
@@ -177,7 +185,7 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest,
 
   workload_ = wc;
 
-  if (working_sets_computed_ && cached_nest == *nest)
+  if (nest_initialized_ && cached_nest == *nest)
   {
     // We've already worked on an identical nest before.
   }
@@ -216,6 +224,7 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest,
     // Properly size working_sets_ by re-constructing it based on now-available
     // parsed workload information.
     working_sets_ = decltype(working_sets_)(workload_->GetShape()->NumDataSpaces);
+    nest_initialized_ = true;
   }
 
   gResetOnStrideChange = !workload_->GetShape()->UsesFlattening; 
@@ -251,7 +260,10 @@ void NestAnalysis::Reset()
   master_spatial_level_.clear();
   linked_spatial_level_.clear();
 
+  nest_initialized_ = false;
   working_sets_computed_ = false;
+  working_set_sizes_computed_ = false;
+  working_set_sizes_.clear();
   imperfectly_factorized_ = false;
   gEnableImperfectCycleCount = false;
 
@@ -276,10 +288,17 @@ void NestAnalysis::Reset()
 
 // Ugly function for pre-checking capacity fits before running the heavyweight
 // ComputeWorkingSets() algorithm. FIXME: Integrate with ComputeWorkingSets().
-std::vector<problem::PerDataSpace<std::size_t>>
-NestAnalysis::GetWorkingSetSizes_LTW() const
+// The sizes only depend on the nest, so they are kept until the next Reset().
+const std::vector<problem::PerDataSpace<std::size_t>>&
+NestAnalysis::GetWorkingSetSizes_LTW()
 {
-  std::vector<problem::PerDataSpace<std::size_t>> working_set_sizes;
+  if (working_set_sizes_computed_)
+  {
+    return working_set_sizes_;
+  }
+
+  auto& working_set_sizes = working_set_sizes_;
+  working_set_sizes.clear();
 
   problem::OperationPoint origin;
   problem::OperationPoint dimension_sizes;
@@ -318,10 +337,12 @@ NestAnalysis::GetWorkingSetSizes_LTW() const
       workload_->SetWorkloadTensorSize(problem::Shape::DataSpaceID(pvi), maxtile.GetDataSpace(pvi));
     workload_->AllTensorsSet();
   }
+
+  working_set_sizes_computed_ = true;
   return working_set_sizes;
 }
 
-problem::PerDataSpace<std::vector<analysis::DataMovementInfo>>
+const problem::PerDataSpace<std::vector<analysis::DataMovementInfo>>&
 NestAnalysis::GetWorkingSets()
 {
   if (!working_sets_computed_)
@@ -332,7 +353,7 @@ NestAnalysis::GetWorkingSets()
   return working_sets_;
 }
 
-analysis::CompoundComputeNest NestAnalysis::GetComputeInfo()
+const analysis::CompoundComputeNest& NestAnalysis::GetComputeInfo()
 {
   if (!working_sets_computed_)
   {
@@ -346,7 +367,7 @@ problem::Workload* NestAnalysis::GetWorkload(){
   return workload_;
 }
 
-layout::Layouts NestAnalysis::GetLayout(){
+const layout::Layouts& NestAnalysis::GetLayout(){
   return layout_;
 }
 
@@ -366,12 +387,23 @@ std::ostream& operator << (std::ostream& out, const NestAnalysis& n)
 
 void NestAnalysis::ComputeWorkingSets()
 {
+  nest_initialized_ = false;
+
   if (nest_state_.size() != 0)
   {
     InitializeNestProperties();
     InitializeLiveState();
     DetectImperfectFactorization();
-    if (!gUseIslAnalysis)
+    if (!gUseIslAnalysis && ClosedFormApplicable())
+    {
+      ComputeClosedFormDeltas();
+      CollectWorkingSets();
+      if (gCheckClosedFormAnalysis)
+      {
+        CheckWorkingSetsAgainstWalk("closed-form nest analysis");
+      }
+    }
+    else if (!gUseIslAnalysis)
     {
       // Recursive call starting from the last element of the list.
       num_epochs_ = 1;
@@ -416,6 +448,7 @@ void NestAnalysis::ComputeWorkingSets()
   }
 
   // Done.
+  nest_initialized_ = true;
   working_sets_computed_ = true;
 }
 
@@ -646,6 +679,87 @@ void NestAnalysis::CollectWorkingSets()
 
 }
 
+// Re-runs the analysis with a plain walk of the nest, with no shortcut, and
+// warns if the results collected before (by the given method) differ. The
+// walked results are kept.
+void NestAnalysis::CheckWorkingSetsAgainstWalk(const std::string& method)
+{
+  auto fast_working_sets = working_sets_;
+  auto fast_compute_info = compute_info_sets_;
+
+  for (auto& tile_nest : working_sets_)
+  {
+    tile_nest.clear();
+  }
+  InitializeLiveState();
+  num_epochs_ = 1;
+  ComputeDeltas(nest_state_.rbegin());
+  CollectWorkingSets();
+
+  auto Close = [](double x, double y)
+  {
+    return std::abs(x - y) <= 1e-9 * std::max(1.0, std::max(std::abs(x), std::abs(y)));
+  };
+
+  auto SameStats = [&](const AccessStatMatrix& x, const AccessStatMatrix& y)
+  {
+    if (x.stats.size() != y.stats.size())
+    {
+      return false;
+    }
+    for (auto it = x.stats.begin(), jt = y.stats.begin(); it != x.stats.end(); it++, jt++)
+    {
+      if (it->first != jt->first || !Close(it->second.accesses, jt->second.accesses) ||
+          !Close(it->second.hops, jt->second.hops) ||
+          !Close(it->second.unicast_hops, jt->second.unicast_hops))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  bool match = fast_compute_info.size() == compute_info_sets_.size();
+  for (unsigned i = 0; match && i < compute_info_sets_.size(); i++)
+  {
+    match = fast_compute_info[i].replication_factor == compute_info_sets_[i].replication_factor &&
+            Close(fast_compute_info[i].accesses, compute_info_sets_[i].accesses);
+  }
+
+  for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
+  {
+    auto& expected = working_sets_[pv];
+    auto& actual = fast_working_sets[pv];
+    if (expected.size() != actual.size())
+    {
+      match = false;
+      continue;
+    }
+    for (unsigned i = 0; i < expected.size(); i++)
+    {
+      if (expected[i].size != actual[i].size ||
+          !Close(expected[i].link_transfers, actual[i].link_transfers) ||
+          !SameStats(expected[i].access_stats, actual[i].access_stats))
+      {
+        match = false;
+        std::cerr << "WARNING: " << method << " mismatch for data space "
+                  << workload_->GetShape()->DataSpaceIDToName.at(pv) << " at tile " << i
+                  << ": size " << actual[i].size << " vs " << expected[i].size
+                  << ", link transfers " << actual[i].link_transfers << " vs "
+                  << expected[i].link_transfers << std::endl;
+        std::cerr << "  " << method << ":" << std::endl << actual[i].access_stats;
+        std::cerr << "  walk:" << std::endl << expected[i].access_stats;
+      }
+    }
+  }
+
+  if (!match)
+  {
+    std::cerr << "WARNING: " << method << " differs from walking the nest:" << std::endl
+              << *this;
+  }
+}
+
 // All but last vector.
 std::vector<unsigned> AllButLast(const std::vector<unsigned>& v)
 {
@@ -1602,6 +1716,67 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
   } // level > 0  
 }
 
+// Computes the number of hops from the edge of the array (at this level) to
+// the nodes in the match set, and the sum of the unicast hops to each node.
+// Assume injection point is at center of V-axis. Routing algorithm is to go
+// along H maximally, then drop vertical paths.
+void NestAnalysis::MulticastHops(const std::vector<std::uint64_t>& match_set,
+                                 std::uint64_t h_size, std::uint64_t v_size,
+                                 double& hops, double& unicast_hops)
+{
+  hops = 0;
+  unicast_hops = 0;
+
+  // Create maps of max and min v coordinate at each h coordinate.
+  struct MinMax { std::uint64_t min; std::uint64_t max; };
+  std::map<std::uint64_t, MinMax> v_minmax_at_h;
+        
+  std::uint64_t h_max = 0;
+  double v_center = double(v_size-1) / 2;
+
+  for (auto& linear_id : match_set)
+  {
+    std::uint64_t h_id = linear_id % h_size;
+    std::uint64_t v_id = linear_id / h_size;
+          
+    h_max = std::max(h_max, h_id);
+
+    auto it = v_minmax_at_h.find(h_id);
+    if (it == v_minmax_at_h.end())
+    {
+      v_minmax_at_h[h_id] = { v_id, v_id };
+    }
+    else
+    {
+      it->second.min = std::min(it->second.min, v_id);
+      it->second.max = std::max(it->second.max, v_id);
+    }
+
+    unicast_hops += double(h_id);
+    unicast_hops += std::abs(double(v_id) - v_center);
+  }
+
+  hops += double(h_max);
+
+  // Walk through the minmax and see how far to drive the v lines.
+  for (auto& minmax : v_minmax_at_h)
+  {
+    auto min = minmax.second.min;
+    auto max = minmax.second.max;
+
+    double min_offset = double(min) - v_center;
+    double max_offset = double(max) - v_center;
+
+    assert(min_offset <= max_offset);
+
+    if (min_offset < 0)
+      hops += std::abs(min_offset);
+
+    if (max_offset > 0)
+      hops += max_offset;
+  }
+}
+
 // Exhaustively compare all pairs of deltas and infer multicast opportunities.
 void NestAnalysis::ComputeAccurateMulticastedAccesses(
     std::vector<analysis::LoopState>::reverse_iterator cur,
@@ -1711,65 +1886,12 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
         temp_struct.accesses += (delta.GetSize(pv) * num_epochs_);
         temp_struct.scatter_factor++;
 
-        // Compute the average number of hops from the edge of the array
-        // (at this level) to the nodes in the match set.
-        // Assume injection point is at center of V-axis. Routing algorithm is
-        // to go along H maximally, then drop vertical paths.
-
         ASSERT(num_matches[pv] == match_set[pv].size());
         
         double hops = 0;
         double unicast_hops = 0;
+        MulticastHops(match_set[pv], h_size, v_size, hops, unicast_hops);
 
-        // Create maps of max and min v coordinate at each h coordinate.
-        struct MinMax { std::uint64_t min; std::uint64_t max; };
-        std::map<std::uint64_t, MinMax> v_minmax_at_h;
-        
-        std::uint64_t h_max = 0;
-        double v_center = double(v_size-1) / 2;
-
-        for (auto& linear_id : match_set[pv])
-        {
-          std::uint64_t h_id = linear_id % h_size;
-          std::uint64_t v_id = linear_id / h_size;
-          
-          h_max = std::max(h_max, h_id);
-
-          auto it = v_minmax_at_h.find(h_id);
-          if (it == v_minmax_at_h.end())
-          {
-            v_minmax_at_h[h_id] = { v_id, v_id };
-          }
-          else
-          {
-            it->second.min = std::min(it->second.min, v_id);
-            it->second.max = std::max(it->second.max, v_id);
-          }
-
-          unicast_hops += double(h_id);
-          unicast_hops += std::abs(double(v_id) - v_center);
-        }
-
-        hops += double(h_max);
-
-        // Walk through the minmax and see how far to drive the v lines.
-        for (auto& minmax : v_minmax_at_h)
-        {
-          auto min = minmax.second.min;
-          auto max = minmax.second.max;
-
-          double min_offset = double(min) - v_center;
-          double max_offset = double(max) - v_center;
-
-          assert(min_offset <= max_offset);
-
-          if (min_offset < 0)
-            hops += std::abs(min_offset);
-
-          if (max_offset > 0)
-            hops += max_offset;
-        }
-        
         // Accumulate this into the running hop count. We'll finally divide this
         // by the scatter factor to get average hop count.
         temp_struct.hops += hops;
@@ -1800,10 +1922,8 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
 // because senders and receivers are at the same storage level, and we only
 // track aggregate stats per level. 
 void NestAnalysis::CompareSpatioTemporalDeltas(
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& cur_spatial_deltas,
-    const std::unordered_map<std::uint64_t, problem::OperationSpace>& prev_spatial_deltas,
-    //const std::vector<problem::OperationSpace>& cur_spatial_deltas,
-    //const std::vector<problem::OperationSpace>& prev_spatial_deltas,
+    const SpatialDeltaCorners& cur_spatial_deltas,
+    const SpatialDeltaCorners& prev_spatial_deltas,
     const std::uint64_t cur_spatial_index,
     const std::uint64_t prev_spatial_index,
     std::vector<problem::PerDataSpace<bool>>& inter_elem_reuse,
@@ -1811,26 +1931,14 @@ void NestAnalysis::CompareSpatioTemporalDeltas(
 {
   //PrintSpaceTimeStamp();
   //std::cout << "comparing " << cur_spatial_index << " vs " << prev_spatial_index << std::endl;
-  
-  auto cur_delta_it = cur_spatial_deltas.find(cur_spatial_index);
-  if (cur_delta_it == cur_spatial_deltas.end())
-    return;
-
-  auto prev_delta_it = prev_spatial_deltas.find(prev_spatial_index);
-  if (prev_delta_it == prev_spatial_deltas.end())
-    return;
-
-  auto& cur_delta = cur_delta_it->second;
-  auto& prev_delta = prev_delta_it->second;
-
-  //std::cout << "  cur : " << cur_delta << std::endl;
-  //std::cout << "  prev: " << prev_delta << std::endl;
 
+  // Missing children are stored as empty, so an element that was not sent a
+  // delta in either iteration never matches.
   for (unsigned pv = 0; pv < workload_->GetShape()->NumDataSpaces; pv++)
   {
-    if (!ignore_dataspaces[pv] && !cur_delta.IsEmpty(pv))
+    if (!ignore_dataspaces[pv] && !cur_spatial_deltas.IsEmpty(cur_spatial_index, pv))
     {
-      if (cur_delta.CheckEquality(prev_delta, pv))
+      if (cur_spatial_deltas.Equals(cur_spatial_index, prev_spatial_deltas, prev_spatial_index, pv))
       {
         // ASSERT(!inter_elem_reuse[cur_spatial_index][pv]);
         inter_elem_reuse.at(cur_spatial_index)[pv] = true;
@@ -1912,6 +2020,11 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
   // Return if there's no transfers allowed at all
   if(std::all_of(no_link_transfer.begin(), no_link_transfer.end(), [](bool v) { return v; })) {return;}
 
+  // The deltas are compared in their compact form, which is also what is kept
+  // as the previous deltas for the next iteration.
+  SpatialDeltaCorners cur_corners;
+  cur_corners.Assign(cur_spatial_deltas, num_spatial_elems, workload_->GetShape()->NumDataSpaces);
+
   // for each spatial elements, this array records if the data
   // needed by the element can be obtained from any of the neighboring elements.
   std::vector<problem::PerDataSpace<bool>> inter_elem_reuse(num_spatial_elems, workload_->GetShape()->NumDataSpaces);
@@ -1935,7 +2048,7 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
       {
         auto cur_skewed_spatial_index = GetLinearIndex(h_id, v_id);
         auto prev_skewed_spatial_index = GetLinearIndex(h_id, (v_id - 1 + v_size) % v_size);
-        CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
+        CompareSpatioTemporalDeltas(cur_corners, prev_spatial_deltas,
                                     cur_skewed_spatial_index, prev_skewed_spatial_index,
                                     inter_elem_reuse,
                                     no_link_transfer);
@@ -1949,7 +2062,7 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
       {
         auto cur_skewed_spatial_index = GetLinearIndex(h_id, v_id);
         auto prev_skewed_spatial_index = GetLinearIndex(h_id, (v_id + 1) % v_size);
-        CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
+        CompareSpatioTemporalDeltas(cur_corners, prev_spatial_deltas,
                                     cur_skewed_spatial_index, prev_skewed_spatial_index,
                                     inter_elem_reuse,
                                     no_link_transfer);
@@ -1966,7 +2079,7 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
       {
         auto cur_skewed_spatial_index = GetLinearIndex(h_id, v_id);
         auto prev_skewed_spatial_index = GetLinearIndex((h_id - 1 + h_size) % h_size, v_id);
-        CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
+        CompareSpatioTemporalDeltas(cur_corners, prev_spatial_deltas,
                                     cur_skewed_spatial_index, prev_skewed_spatial_index,
                                     inter_elem_reuse,
                                     no_link_transfer);
@@ -1980,7 +2093,7 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
       {
         auto cur_skewed_spatial_index = GetLinearIndex(h_id, v_id);
         auto prev_skewed_spatial_index = GetLinearIndex((h_id + 1) % h_size, v_id);
-        CompareSpatioTemporalDeltas(cur_spatial_deltas, prev_spatial_deltas,
+        CompareSpatioTemporalDeltas(cur_corners, prev_spatial_deltas,
                                     cur_skewed_spatial_index, prev_skewed_spatial_index,
                                     inter_elem_reuse,
                                     no_link_transfer);
@@ -2007,7 +2120,7 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
   }
 
   // Time-shift the data in prev_spatial_deltas array
-  cur_state.prev_spatial_deltas = cur_spatial_deltas;
+  cur_state.prev_spatial_deltas = std::move(cur_corners);
 
   // for (std::uint64_t i = 1; i < analysis::ElementState::MAX_TIME_LAPSE; i++)
   // {
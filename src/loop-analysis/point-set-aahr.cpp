@@ -25,6 +25,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <iostream>
 
 #include "loop-analysis/point-set.hpp"
@@ -560,6 +561,46 @@ std::vector<AxisAlignedHyperRectangle> AxisAlignedHyperRectangle::MultiSubtract(
   return retval;    
 }
 
+unsigned AxisAlignedHyperRectangle::SubtractUnlessSplintered(const AxisAlignedHyperRectangle& b)
+{
+  for (unsigned rank = 0; rank < order_; rank++)
+  {
+    if (max_[rank] <= b.min_[rank] || b.max_[rank] <= min_[rank])
+      return 1;
+  }
+
+  // MultiSubtract() cuts one slice for each rank and side in which this AAHR
+  // sticks out of b.
+  unsigned num_slices = 0;
+  unsigned slice_rank = 0;
+  bool left_slice = false;
+  for (unsigned rank = 0; rank < order_; rank++)
+  {
+    if (min_[rank] < b.min_[rank])
+    {
+      num_slices++;
+      slice_rank = rank;
+      left_slice = true;
+    }
+    if (b.max_[rank] < max_[rank])
+    {
+      num_slices++;
+      slice_rank = rank;
+      left_slice = false;
+    }
+  }
+
+  if (num_slices == 1)
+  {
+    if (left_slice)
+      max_[slice_rank] = b.min_[slice_rank];
+    else
+      min_[slice_rank] = b.max_[slice_rank];
+  }
+
+  return std::min(num_slices, 2u);
+}
+
 bool AxisAlignedHyperRectangle::Contains(const Point& p) const
 {
   ASSERT(p.Order() == order_);
@@ -692,6 +733,12 @@ void AxisAlignedHyperRectangle::Translate(const Point& p)
   }    
 }
 
+void AxisAlignedHyperRectangle::AppendCorners(std::vector<Coordinate>& corners) const
+{
+  corners.insert(corners.end(), min_.data(), min_.data() + order_);
+  corners.insert(corners.end(), max_.data(), max_.data() + order_);
+}
+
 void AxisAlignedHyperRectangle::Print(std::ostream& out) const
 {
   out << "["; 
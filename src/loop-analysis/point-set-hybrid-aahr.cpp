@@ -0,0 +1,372 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "loop-analysis/point-set-hybrid-aahr.hpp"
+
+bool gInlineSingleAAHR =
+  (getenv("TIMELOOP_POINT_SET_BACKEND") == NULL) ||
+  (strcmp(getenv("TIMELOOP_POINT_SET_BACKEND"), "multi-aahr") != 0);
+
+HybridAAHR::HybridAAHR(std::uint32_t order) :
+    order_(order),
+    num_inline_(0),
+    inline_(0),
+    promoted_(!gInlineSingleAAHR),
+    multi_(order)
+{
+}
+
+HybridAAHR::HybridAAHR(std::uint32_t order, const Point unit) :
+    order_(order),
+    num_inline_(1),
+    inline_(order, unit),
+    promoted_(false),
+    multi_(order)
+{
+  if (!gInlineSingleAAHR)
+  {
+    Promote();
+  }
+}
+
+HybridAAHR::HybridAAHR(std::uint32_t order, const Point min, const Point max) :
+    order_(order),
+    num_inline_(1),
+    inline_(order, min, max),
+    promoted_(false),
+    multi_(order)
+{
+  if (!gInlineSingleAAHR)
+  {
+    Promote();
+  }
+}
+
+HybridAAHR::HybridAAHR(std::uint32_t order, const std::vector<std::pair<Point, Point>> corner_sets) :
+    order_(order),
+    num_inline_(0),
+    inline_(0),
+    promoted_(true),
+    multi_(order, corner_sets)
+{
+  DemoteIfSingle();
+}
+
+HybridAAHR::HybridAAHR(const HybridAAHR& a) :
+    order_(a.order_),
+    num_inline_(a.num_inline_),
+    inline_(a.inline_),
+    promoted_(a.promoted_),
+    multi_(a.multi_)
+{
+}
+
+// Copy-and-swap idiom.
+HybridAAHR& HybridAAHR::operator = (HybridAAHR other)
+{
+  swap(*this, other);
+  return *this;
+}
+
+void swap(HybridAAHR& first, HybridAAHR& second)
+{
+  using std::swap;
+  swap(first.order_, second.order_);
+  swap(first.num_inline_, second.num_inline_);
+  swap(first.inline_, second.inline_);
+  swap(first.promoted_, second.promoted_);
+  swap(first.multi_, second.multi_);
+}
+
+MultiAAHR HybridAAHR::AsMulti() const
+{
+  if (promoted_)
+  {
+    return multi_;
+  }
+
+  MultiAAHR retval(order_);
+  if (num_inline_ == 1)
+  {
+    retval.aahrs_.push_back(inline_);
+  }
+  return retval;
+}
+
+void HybridAAHR::Promote()
+{
+  if (promoted_)
+  {
+    return;
+  }
+
+  multi_.aahrs_.clear();
+  if (num_inline_ == 1)
+  {
+    multi_.aahrs_.push_back(inline_);
+  }
+  num_inline_ = 0;
+  promoted_ = true;
+}
+
+void HybridAAHR::DemoteIfSingle()
+{
+  if (!promoted_ || !gInlineSingleAAHR || multi_.aahrs_.size() > 1)
+  {
+    return;
+  }
+
+  num_inline_ = multi_.aahrs_.size();
+  if (num_inline_ == 1)
+  {
+    swap(inline_, multi_.aahrs_.front());
+  }
+  multi_.aahrs_.clear();
+  promoted_ = false;
+}
+
+std::size_t HybridAAHR::size() const
+{
+  if (promoted_)
+    return multi_.size();
+  return num_inline_ == 1 ? inline_.size() : 0;
+}
+
+bool HybridAAHR::empty() const
+{
+  if (promoted_)
+    return multi_.empty();
+  return num_inline_ == 0 || inline_.empty();
+}
+
+std::uint32_t HybridAAHR::numAAHRs() const
+{
+  if (promoted_)
+    return multi_.numAAHRs();
+  return num_inline_;
+}
+
+void HybridAAHR::Reset()
+{
+  num_inline_ = 0;
+  multi_.Reset();
+  promoted_ = !gInlineSingleAAHR;
+}
+
+HybridAAHR& HybridAAHR::operator += (const Point& p)
+{
+  if (promoted_)
+  {
+    multi_ += p;
+    return *this;
+  }
+
+  if (num_inline_ == 0)
+  {
+    inline_ = AxisAlignedHyperRectangle(order_, p);
+    num_inline_ = 1;
+    return *this;
+  }
+
+  if (inline_.Contains(p) || inline_.MergeIfAdjacent(p))
+  {
+    return *this;
+  }
+
+  Promote();
+  multi_.aahrs_.push_back(AxisAlignedHyperRectangle(order_, p));
+  return *this;
+}
+
+void HybridAAHR::Subtract(const HybridAAHR& other)
+{
+  if (!promoted_ && !other.promoted_)
+  {
+    if (num_inline_ == 0 || other.num_inline_ == 0)
+    {
+      return;
+    }
+
+    auto num_splinters = inline_.SubtractUnlessSplintered(other.inline_);
+    if (num_splinters <= 1)
+    {
+      num_inline_ = num_splinters;
+      return;
+    }
+
+    multi_.aahrs_ = inline_.MultiSubtract(other.inline_);
+    num_inline_ = 0;
+    promoted_ = true;
+    return;
+  }
+
+  Promote();
+  if (other.promoted_)
+  {
+    multi_.Subtract(other.multi_);
+  }
+  else
+  {
+    multi_.Subtract(other.AsMulti());
+  }
+  DemoteIfSingle();
+}
+
+HybridAAHR& HybridAAHR::operator += (const HybridAAHR& s)
+{
+  // As MultiAAHR: remove the overlap, then append s's AAHRs.
+  Subtract(s);
+
+  if (!s.promoted_)
+  {
+    if (s.num_inline_ == 0 || s.inline_.empty())
+    {
+      return *this;
+    }
+    if (!promoted_ && num_inline_ == 0)
+    {
+      inline_ = s.inline_;
+      num_inline_ = 1;
+      return *this;
+    }
+    Promote();
+    multi_.aahrs_.push_back(s.inline_);
+    return *this;
+  }
+
+  Promote();
+  for (auto& aahr: s.multi_.aahrs_)
+  {
+    if (!aahr.empty())
+      multi_.aahrs_.push_back(aahr);
+  }
+  DemoteIfSingle();
+  return *this;
+}
+
+HybridAAHR HybridAAHR::operator - (const HybridAAHR& other)
+{
+  HybridAAHR delta(*this);
+  delta.Subtract(other);
+  return delta;
+}
+
+bool HybridAAHR::operator == (const HybridAAHR& s) const
+{
+  if (!promoted_ && !s.promoted_)
+  {
+    return num_inline_ == s.num_inline_ &&
+           (num_inline_ == 0 || inline_ == s.inline_);
+  }
+  if (promoted_ && s.promoted_)
+  {
+    return multi_ == s.multi_;
+  }
+  return AsMulti() == s.AsMulti();
+}
+
+Point HybridAAHR::GetTranslation(const HybridAAHR& s) const
+{
+  if (promoted_ || s.promoted_)
+  {
+    return AsMulti().GetTranslation(s.AsMulti());
+  }
+
+  // MultiAAHR::GetTranslation() on single-AAHR sets: the rounded distance
+  // between the centroids, or 0 if either set is null.
+  Point retval(order_);
+
+  std::size_t size_a = num_inline_ == 1 ? inline_.size() : 0;
+  std::size_t size_b = s.num_inline_ == 1 ? s.inline_.size() : 0;
+  if (size_a > 0 && size_b > 0)
+  {
+    auto centroid_a = inline_.Centroid();
+    auto centroid_b = s.inline_.Centroid();
+    for (unsigned rank = 0; rank < order_; rank++)
+    {
+      double weighted_centroid_a = centroid_a[rank] * size_a / double(size_a);
+      double weighted_centroid_b = centroid_b[rank] * size_b / double(size_b);
+      retval[rank] = static_cast<Coordinate>(round(weighted_centroid_b - weighted_centroid_a));
+    }
+  }
+
+  return retval;
+}
+
+void HybridAAHR::Translate(const Point& p)
+{
+  if (promoted_)
+  {
+    multi_.Translate(p);
+  }
+  else if (num_inline_ == 1)
+  {
+    inline_.Translate(p);
+  }
+}
+
+std::vector<AxisAlignedHyperRectangle> HybridAAHR::GetAAHRs() const
+{
+  if (promoted_)
+  {
+    return multi_.GetAAHRs();
+  }
+  assert(num_inline_ != 0);
+  return { inline_ };
+}
+
+void HybridAAHR::AppendCorners(std::vector<Coordinate>& corners) const
+{
+  if (promoted_)
+  {
+    multi_.AppendCorners(corners);
+  }
+  else if (num_inline_ == 1)
+  {
+    inline_.AppendCorners(corners);
+  }
+}
+
+std::ostream& operator << (std::ostream& out, const HybridAAHR& h)
+{
+  if (h.promoted_)
+  {
+    return out << h.multi_;
+  }
+
+  out << "{ ";
+  if (h.num_inline_ == 1)
+  {
+    out << h.inline_ << ", ";
+  }
+  out << "}";
+  return out;
+}
@@ -25,6 +25,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "loop-analysis/point-set-multi-aahr.hpp"
@@ -309,6 +310,26 @@ void MultiAAHR::Translate(const Point& p)
   }
 }
 
+void MultiAAHR::AppendCorners(std::vector<Coordinate>& corners) const
+{
+  if (aahrs_.size() == 1)
+  {
+    aahrs_.front().AppendCorners(corners);
+    return;
+  }
+
+  std::vector<std::vector<Coordinate>> aahr_corners(aahrs_.size());
+  for (unsigned i = 0; i < aahrs_.size(); i++)
+  {
+    aahrs_[i].AppendCorners(aahr_corners[i]);
+  }
+  std::sort(aahr_corners.begin(), aahr_corners.end());
+  for (auto& x: aahr_corners)
+  {
+    corners.insert(corners.end(), x.begin(), x.end());
+  }
+}
+
 std::vector<AxisAlignedHyperRectangle> MultiAAHR::GetAAHRs() const
 {
   assert(aahrs_.size() != 0);
@@ -858,21 +858,22 @@ void ResetBackingStorageFillsPlaceHolder(std::vector<DataMovementInfo>& tile_nes
 }
 
 
-tiling::CompoundTileNest CollapseTiles(analysis::CompoundTileNest& tiles,
+tiling::CompoundTileNest CollapseTiles(const analysis::CompoundDataMovementNest& data_movement_nest,
+                                       const analysis::CompoundComputeNest& compute_nest,
                                        int num_tiling_levels,
                                        const CompoundMaskNest& tile_mask,
                                        const CompoundMaskNest& distribution_supported,
                                        const problem::Workload* workload)
 {
-  CompoundDataMovementNest collapsed_compound_data_nest = CollapseDataMovementNest(tiles.compound_data_movement_info_nest,
+  CompoundDataMovementNest collapsed_compound_data_nest = CollapseDataMovementNest(data_movement_nest,
                                                                                    num_tiling_levels,
                                                                                    tile_mask,
                                                                                    distribution_supported, 
                                                                                    workload);
-  ComputeNest collapsed_compound_compute_nest = CollapseComputeNest(tiles.compound_compute_info_nest, num_tiling_levels); 
+  ComputeNest collapsed_compound_compute_nest = CollapseComputeNest(compute_nest, num_tiling_levels);
   tiling::CompoundTileNest solution;
-  solution.compound_data_movement_info_nest = collapsed_compound_data_nest;
-  solution.compute_info_nest = collapsed_compound_compute_nest;
+  solution.compound_data_movement_info_nest = std::move(collapsed_compound_data_nest);
+  solution.compute_info_nest = std::move(collapsed_compound_compute_nest);
 
   // -- FIXME -- we don't need both compute_cycles and max_temporal iterations.
   // The latter is a temporary hack for Ruby. The former is needed for sparse
@@ -882,7 +883,7 @@ tiling::CompoundTileNest CollapseTiles(analysis::CompoundTileNest& tiles,
 }
 
 
-ComputeNest CollapseComputeNest(analysis::CompoundComputeNest& tiles, int num_tiling_levels)
+ComputeNest CollapseComputeNest(const analysis::CompoundComputeNest& tiles, int num_tiling_levels)
 {
   ComputeNest solution;
   
@@ -941,7 +942,7 @@ void PrintTiles(std::vector<DataMovementInfo>& tile_nest)
 // Collapse tiles into a given number of levels.
 // Input and output are both arrays of tile nests,
 // with one nest per problem::Shape::DataSpaceID.
-CompoundDataMovementNest CollapseDataMovementNest(analysis::CompoundDataMovementNest& tiles, 
+CompoundDataMovementNest CollapseDataMovementNest(const analysis::CompoundDataMovementNest& tiles,
                                                   int num_tiling_levels,
                                                   const CompoundMaskNest& tile_mask,
                                                   const CompoundMaskNest& distribution_supported,
@@ -1109,30 +1110,37 @@ void SetParentChildPointers(tiling::NestOfCompoundTiles& nest_of_compound_tiles,
 
 NestOfCompoundTiles TransposeTiles(const CompoundTileNest& tiles,
                                    const problem::Workload* workload)
+{
+  return TransposeTiles(CompoundTileNest(tiles), workload);
+}
+
+NestOfCompoundTiles TransposeTiles(CompoundTileNest&& tiles,
+                                   const problem::Workload* workload)
 {
   NestOfCompoundTiles retval;
 
-  const CompoundDataMovementNest& data_movement_nest =  tiles.compound_data_movement_info_nest;
-  const ComputeNest& compute_nest = tiles.compute_info_nest;
+  CompoundDataMovementNest& data_movement_nest =  tiles.compound_data_movement_info_nest;
+  ComputeNest& compute_nest = tiles.compute_info_nest;
 
   unsigned num_levels = data_movement_nest[0].size();
-  CompoundTile tile_level;
-  ComputeInfo compute_info = compute_nest[0];
+  retval.reserve(num_levels);
 
-  // transpose all the tiles
+  // transpose all the tiles, moving each DataMovementInfo into place rather
+  // than copying its vectors and maps.
   for (unsigned level = 0; level < num_levels; level++)
   {
-    // Property re-initialize data_movement_info based on workload shape.
+    auto& tile_level = retval.emplace_back();
+
+    // Property initialize data_movement_info based on workload shape.
     tile_level.data_movement_info = decltype(tile_level.data_movement_info)(workload->GetShape()->NumDataSpaces);
     
     //  Datamovement
     for (int pv = 0; pv < int(workload->GetShape()->NumDataSpaces); pv++)
     {
-      tile_level.data_movement_info[pv] = data_movement_nest[pv][level];
+      tile_level.data_movement_info[pv] = std::move(data_movement_nest[pv][level]);
     }
     //  Compute
-    tile_level.compute_info = compute_nest[level];
-    retval.push_back(tile_level);
+    tile_level.compute_info = std::move(compute_nest[level]);
   }
 
   // set pointers inside each tile object, so that it is more convenient to perform overbooking analysis in model
@@ -26,6 +26,8 @@
  */
 
 #include <regex>
+#include <stdexcept>
+#include <string>
 
 #include "mapping/parser.hpp"
 #include "mapping/arch-properties.hpp"
@@ -98,7 +100,10 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
   }
 
   // Parse user-provided mapping.
-  assert(config.isList());
+  if (!config.isList())
+  {
+    throw std::runtime_error("mapping must be a list of directives");
+  }
   
   // Iterate over all the directives.
   int len = config.getLength();
@@ -144,9 +149,8 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
               }
               catch (std::out_of_range& oor)
               {
-                std::cerr << "ERROR: parsing no_link_transfer setting: data-space " << datatype_string
-                          << " not found in problem shape." << std::endl;
-                exit(1);
+                throw std::runtime_error("parsing no_link_transfer setting: data-space " + datatype_string +
+                                         " not found in problem shape");
               }
             }
           }
@@ -175,9 +179,8 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
             }
             catch (std::out_of_range& oor)
             {
-              std::cerr << "ERROR: parsing no_multicast_no_reduction setting: data-space " << datatype_string
-                        << " not found in problem shape." << std::endl;
-              exit(1);
+              throw std::runtime_error("parsing no_multicast_no_reduction setting: data-space " + datatype_string +
+                                       " not found in problem shape");
             }
           }
         }
@@ -206,9 +209,8 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
             }
             catch (std::out_of_range& oor)
             {
-              std::cerr << "ERROR: parsing no_temporal_reuse setting: data-space " << datatype_string
-                        << " not found in problem shape." << std::endl;
-              exit(1);
+              throw std::runtime_error("parsing no_temporal_reuse setting: data-space " + datatype_string +
+                                       " not found in problem shape");
             }
           }
         }
@@ -230,9 +232,8 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
               }
               catch (std::out_of_range& oor)
               {
-                std::cerr << "ERROR: parsing rmw_first_update setting: data-space " << datatype_string
-                          << " not found in problem shape." << std::endl;
-                exit(1);
+                throw std::runtime_error("parsing rmw_first_update setting: data-space " + datatype_string +
+                                         " not found in problem shape");
               }
             }
           }
@@ -264,9 +265,8 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
             }
             catch (std::out_of_range& oor)
             {
-              std::cerr << "ERROR: parsing no_coalesce setting: data-space " << datatype_string
-                        << " not found in problem shape." << std::endl;
-              exit(1);
+              throw std::runtime_error("parsing no_coalesce setting: data-space " + datatype_string +
+                                       " not found in problem shape");
             }
           }
         }
@@ -280,8 +280,7 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
     }
     else
     {
-      std::cerr << "ERROR: illegal mapping directive type: " << type << std::endl;
-      std::exit(1);
+      throw std::runtime_error("illegal mapping directive type: " + type);
     }
   } // Done iterating through user-provided directives.
 
@@ -386,23 +385,17 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
     prod[dim]++;
 
   // All user-provided factors must multiply-up to the dimension size.
-  bool fault = false;
   for (unsigned dim = 0; dim < workload.GetShape()->NumFlattenedDimensions; dim++)
   {
     if (prod[dim] != workload.GetFlattenedBound(dim))
     {
-      std::cerr << "ERROR: parsing mapping: product of all factors of dimension "
-                << workload.GetShape()->FlattenedDimensionIDToName.at(dim) << " is "
-                << prod[dim] << ", which is not equal to "
-                << "the dimension size of the workload " << workload.GetFlattenedBound(dim)
-                << "." << std::endl;
-      fault = true;
+      throw std::runtime_error("parsing mapping: product of all factors of dimension " +
+                               workload.GetShape()->FlattenedDimensionIDToName.at(dim) + " is " +
+                               std::to_string(prod[dim]) + ", which is not equal to " +
+                               "the dimension size of the workload " +
+                               std::to_string(workload.GetFlattenedBound(dim)));
     }
   }
-  if (fault)
-  {
-    exit(1);
-  }
 
   // Concatenate the subnests to form the final mapping nest.
   Mapping mapping(&workload);
@@ -509,8 +502,7 @@ unsigned FindTargetStorageLevel(config::CompoundConfigNode directive)
     }
     if (storage_level_id == num_storage_levels)
     {
-      std::cerr << "ERROR: target storage level not found: " << storage_level_name << std::endl;
-      exit(1);
+      throw std::runtime_error("target storage level not found: " + storage_level_name);
     }
   }
   else
@@ -551,23 +543,20 @@ unsigned FindTargetTilingLevel(config::CompoundConfigNode directive, std::string
     }
     catch (const std::out_of_range& oor)
     {
-      std::cerr << "ERROR: cannot find spatial tiling level associated with "
-                << "storage level " << arch_props_.StorageLevelName(storage_level_id)
-                << ". This is because the number of instances of the next-inner "
-                << "level ";
+      std::string msg = "cannot find spatial tiling level associated with storage level " +
+        arch_props_.StorageLevelName(storage_level_id) +
+        ". This is because the number of instances of the next-inner level ";
       if (storage_level_id != 0)
       {
-        std::cerr << "(" << arch_props_.StorageLevelName(storage_level_id-1) << ") ";
+        msg += "(" + arch_props_.StorageLevelName(storage_level_id-1) + ") ";
       }
-      std::cerr << "is the same as this level, which means there cannot "
-                << "be a spatial fanout." << std::endl;
-      exit(1);
+      msg += "is the same as this level, which means there cannot be a spatial fanout.";
+      throw std::runtime_error(msg);
     }
   }
   else
   {
-    std::cerr << "ERROR: unrecognized mapping directive type: " << type << std::endl;
-    exit(1);
+    throw std::runtime_error("unrecognized mapping directive type: " + type);
   }
 
   return tiling_level_id;
@@ -601,9 +590,8 @@ std::map<problem::Shape::FlattenedDimensionID, std::pair<int,int>> ParseUserFact
       }
       catch (const std::out_of_range& oor)
       {
-        std::cerr << "ERROR: parsing factors: " << buffer << ": dimension " << dimension_name
-                  << " not found in problem shape." << std::endl;
-        exit(1);
+        throw std::runtime_error("parsing factors: " + buffer + ": dimension " + dimension_name +
+                                 " not found in problem shape");
       }
 
       int end = std::stoi(sm[2]);
@@ -655,7 +643,16 @@ std::vector<problem::Shape::FlattenedDimensionID> ParseUserPermutations(config::
     char token;
     while (iss >> token)
     {
-      auto dimension = workload.GetShape()->FlattenedDimensionNameToID.at(std::string(1, token)); // note: can fault.
+      problem::Shape::FlattenedDimensionID dimension;
+      try
+      {
+        dimension = workload.GetShape()->FlattenedDimensionNameToID.at(std::string(1, token));
+      }
+      catch (const std::out_of_range& oor)
+      {
+        throw std::runtime_error("parsing permutation: " + buffer + ": dimension " + std::string(1, token) +
+                                 " not found in problem shape");
+      }
       retval.push_back(dimension);
     }
   }
@@ -678,7 +675,16 @@ void ParseUserDatatypeBypassSettings(config::CompoundConfigNode directive,
     directive.lookupArrayValue("keep", datatype_strings);
     for (const std::string& datatype_string: datatype_strings)
     {
-      auto datatype = workload.GetShape()->DataSpaceNameToID.at(datatype_string);
+      problem::Shape::DataSpaceID datatype;
+      try
+      {
+        datatype = workload.GetShape()->DataSpaceNameToID.at(datatype_string);
+      }
+      catch (const std::out_of_range& oor)
+      {
+        throw std::runtime_error("parsing keep setting: data-space " + datatype_string +
+                                 " not found in problem shape");
+      }
       user_bypass_strings.at(datatype).at(level) = '1';
     }
   }
@@ -690,7 +696,16 @@ void ParseUserDatatypeBypassSettings(config::CompoundConfigNode directive,
     directive.lookupArrayValue("bypass", datatype_strings);
     for (const std::string& datatype_string: datatype_strings)
     {
-      auto datatype = workload.GetShape()->DataSpaceNameToID.at(datatype_string);
+      problem::Shape::DataSpaceID datatype;
+      try
+      {
+        datatype = workload.GetShape()->DataSpaceNameToID.at(datatype_string);
+      }
+      catch (const std::out_of_range& oor)
+      {
+        throw std::runtime_error("parsing bypass setting: data-space " + datatype_string +
+                                 " not found in problem shape");
+      }
       user_bypass_strings.at(datatype).at(level) = '0';
     }
   }
@@ -705,14 +720,12 @@ loop::Nest::SkewDescriptor ParseUserSkew(config::CompoundConfigNode directive, c
 
   if (!directive.lookupValue("modulo", skew_descriptor.modulo))
   {
-    std::cerr << "ERROR: parsing skew directive: no modulo specified." << std::endl;
-    std::exit(1);
+    throw std::runtime_error("parsing skew directive: no modulo specified");
   }
 
   if (!directive.exists("terms"))
   {
-    std::cerr << "ERROR: parsing skew directive: no terms specified." << std::endl;
-    std::exit(1);
+    throw std::runtime_error("parsing skew directive: no terms specified");
   }
 
   auto expr_cfg = directive.lookup("terms");
@@ -743,8 +756,7 @@ loop::Nest::SkewDescriptor ParseUserSkew(config::CompoundConfigNode directive, c
         term.variable.is_spatial = false;
       else
       {
-        std::cerr << "ERROR: skew variable type must be spatial or temporal." << std::endl;
-        std::exit(1);
+        throw std::runtime_error("skew variable type must be spatial or temporal");
       }
     }
 
@@ -762,8 +774,7 @@ loop::Nest::SkewDescriptor ParseUserSkew(config::CompoundConfigNode directive, c
         term.bound.is_spatial = false;
       else
       {
-        std::cerr << "ERROR: skew bound type must be spatial or temporal." << std::endl;
-        std::exit(1);
+        throw std::runtime_error("skew bound type must be spatial or temporal");
       }
     }
 
@@ -41,7 +41,8 @@ MapSpace* ParseAndConstruct(config::CompoundConfigNode config,
                             config::CompoundConfigNode arch_constraints,
                             model::Engine::Specs& arch_specs,
                             const problem::Workload& workload,
-                            bool filter_spatial_fanout)
+                            bool filter_spatial_fanout,
+                            bool permutation_classes)
 {
   MapSpace* mapspace = nullptr;
   
@@ -50,10 +51,12 @@ MapSpace* ParseAndConstruct(config::CompoundConfigNode config,
     
   if (mapspace_template == "uber")
   {
-    mapspace = new Uber(config, arch_constraints, arch_specs, workload, filter_spatial_fanout);
+    mapspace = new Uber(config, arch_constraints, arch_specs, workload, filter_spatial_fanout,
+                        permutation_classes);
   }else if (mapspace_template == "ruby")
   {
-    mapspace = new Ruby(config, arch_constraints, arch_specs, workload);
+    // Ruby keeps its default fanout filtering.
+    mapspace = new Ruby(config, arch_constraints, arch_specs, workload, true, permutation_classes);
   }
   else
   {
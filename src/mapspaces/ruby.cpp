@@ -45,6 +45,7 @@ Ruby::Ruby(
   model::Engine::Specs arch_specs,
   const problem::Workload& workload,
   bool filter_spatial_fanout,
+  bool permutation_classes,
   bool skip_init
 ) :
   MapSpace(arch_specs, workload),
@@ -54,7 +55,8 @@ Ruby::Ruby(
   num_parent_splits_(0),
   arch_props_(arch_specs),
   constraints_(arch_props_, workload),
-  filter_spatial_fanout_(filter_spatial_fanout)
+  filter_spatial_fanout_(filter_spatial_fanout),
+  permutation_classes_(permutation_classes)
 {
   if (!skip_init)
   {
@@ -269,9 +271,11 @@ void Ruby::InitLoopPermutationSpace(std::map<unsigned, std::vector<problem::Shap
       // user-provided pattern. If this pattern is empty or incomplete,
       // it exposes a permutation space. This logic is handled by the
       // permutation space object itself.
+      // Reuse classes need the unit-factor dimensions to have been pruned.
       auto it = pruned_dimensions.find(level);
       if (it != pruned_dimensions.end())
-        permutation_space_.InitLevel(level, user_prefix, user_suffix, it->second);
+        permutation_space_.InitLevel(level, user_prefix, user_suffix, it->second,
+                                     permutation_classes_ && !arch_props_.IsSpatial(level));
       else
         permutation_space_.InitLevel(level, user_prefix, user_suffix);
     }
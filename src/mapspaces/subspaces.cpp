@@ -219,10 +219,34 @@ uint128_t ResidualIndexFactorizationSpace::Size() const
 PermutationSpace::PermutationSpace(const problem::Workload& workload) :
     workload_(workload)
 {
-  for (unsigned i = 0; i < unsigned(workload_.GetShape()->NumFlattenedDimensions); i++)
+  auto shape = workload_.GetShape();
+  assert(shape->NumFlattenedDimensions <= 64);
+
+  for (unsigned i = 0; i < unsigned(shape->NumFlattenedDimensions); i++)
   {
     canonical_pattern_.push_back(problem::Shape::FlattenedDimensionID(i));
   }
+
+  for (unsigned pvi = 0; pvi < shape->NumDataSpaces; pvi++)
+  {
+    // Dimensions of bound 1 never get a loop, so a sliding window over one
+    // of them (e.g., a 1x1 convolution) does not make tiles overlap.
+    std::uint64_t relevant = 0;
+    bool disjoint = !shape->UsesFlattening;
+    for (auto& expression : shape->Projections.at(pvi))
+    {
+      unsigned num_looped_terms = 0;
+      for (auto& term : expression)
+      {
+        auto dim = shape->FactorizedToFlattened.at(term.second);
+        relevant |= std::uint64_t(1) << dim;
+        num_looped_terms += (workload_.GetFlattenedBound(dim) > 1);
+      }
+      disjoint &= (num_looped_terms <= 1);
+    }
+    relevant_dimensions_.push_back(relevant);
+    disjoint_tiles_.push_back(disjoint);
+  }
 }
 
 void PermutationSpace::Init(uint64_t num_levels)
@@ -230,6 +254,92 @@ void PermutationSpace::Init(uint64_t num_levels)
   num_levels_ = num_levels;
   patterns_.clear();
   size_.clear();
+  representatives_.clear();
+}
+
+//
+// Enumerates the permutations of the permutable loops (inner to outer, with
+// the inner and outer loops around them) and keeps the first of each reuse
+// class. An empty result means there are too many permutations to classify.
+//
+const std::vector<std::uint64_t>& PermutationSpace::ReuseClassRepresentatives(
+  const std::vector<problem::Shape::FlattenedDimensionID>& inner,
+  const std::vector<problem::Shape::FlattenedDimensionID>& permutable,
+  const std::vector<problem::Shape::FlattenedDimensionID>& outer)
+{
+  const std::size_t max_classified_loops = 10;
+
+  std::vector<std::vector<problem::Shape::FlattenedDimensionID>> key = { inner, permutable, outer };
+  auto cached = representatives_cache_.find(key);
+  if (cached != representatives_cache_.end())
+  {
+    return cached->second;
+  }
+
+  auto& representatives = representatives_cache_[key];
+  if (permutable.size() <= 1)
+  {
+    representatives.push_back(0);
+    return representatives;
+  }
+  if (permutable.size() > max_classified_loops)
+  {
+    return representatives;
+  }
+
+  std::set<std::vector<std::uint64_t>> classes;
+  std::vector<problem::Shape::FlattenedDimensionID> order = inner;
+  order.insert(order.end(), permutable.begin(), permutable.end());
+  order.insert(order.end(), outer.begin(), outer.end());
+
+  auto num_permutations = factoradic_.Factorial(permutable.size());
+  for (std::uint64_t index = 0; index < num_permutations; index++)
+  {
+    std::copy(permutable.begin(), permutable.end(), order.begin() + inner.size());
+    factoradic_.Permute(order.data() + inner.size(), permutable.size(), index);
+
+    // Per data space, the irrelevant loops between consecutive relevant
+    // ones, starting from the innermost. Loops outside the outermost
+    // relevant one don't matter, nor do those outside the innermost
+    // relevant one if tiles never overlap.
+    std::vector<std::uint64_t> signature;
+    for (unsigned pvi = 0; pvi < relevant_dimensions_.size(); pvi++)
+    {
+      std::uint64_t gap = 0;
+      for (auto dim : order)
+      {
+        std::uint64_t bit = std::uint64_t(1) << dim;
+        if (relevant_dimensions_[pvi] & bit)
+        {
+          signature.push_back(gap);
+          if (disjoint_tiles_[pvi])
+          {
+            break;
+          }
+          signature.push_back(dim);
+          gap = 0;
+        }
+        else
+        {
+          gap |= bit;
+        }
+      }
+      signature.push_back(~std::uint64_t(0));
+    }
+
+    if (classes.insert(signature).second)
+    {
+      representatives.push_back(index);
+    }
+  }
+
+  return representatives;
+}
+
+std::uint64_t PermutationSpace::PermutationIndex(unsigned level, std::uint64_t local_id) const
+{
+  auto it = representatives_.find(level);
+  return it == representatives_.end() ? local_id : it->second.at(local_id);
 }
 
 void PermutationSpace::InitLevelCanonical(uint64_t level)
@@ -240,7 +350,8 @@ void PermutationSpace::InitLevelCanonical(uint64_t level)
 void PermutationSpace::InitLevel(uint64_t level,
                                  std::vector<problem::Shape::FlattenedDimensionID> user_prefix,
                                  std::vector<problem::Shape::FlattenedDimensionID> user_suffix,
-                                 std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions)
+                                 std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions,
+                                 bool reuse_classes)
 {
   assert(level < num_levels_);
 
@@ -280,6 +391,19 @@ void PermutationSpace::InitLevel(uint64_t level,
 
   patterns_[level] = { baked_prefix, permutable_infix, baked_suffix };
   size_[level] = factoradic_.Factorial(permutable_infix.size());
+  representatives_.erase(level);
+
+  if (reuse_classes)
+  {
+    std::vector<problem::Shape::FlattenedDimensionID> inner(baked_prefix.begin() + pruned_dimensions.size(),
+                                                            baked_prefix.end());
+    auto& representatives = ReuseClassRepresentatives(inner, permutable_infix, baked_suffix);
+    if (!representatives.empty())
+    {
+      representatives_[level] = representatives;
+      size_[level] = representatives.size();
+    }
+  }
 }
 
 std::vector<std::vector<problem::Shape::FlattenedDimensionID>>
@@ -295,7 +419,8 @@ PermutationSpace::GetPatterns(uint128_t id)
     if (pattern.permutable_infix.size() > 0)
     {
       std::vector<problem::Shape::FlattenedDimensionID> permuted_infix = pattern.permutable_infix;
-      factoradic_.Permute(permuted_infix.data(), permuted_infix.size(), std::uint64_t(id % size_.at(level)));
+      factoradic_.Permute(permuted_infix.data(), permuted_infix.size(),
+                          PermutationIndex(level, std::uint64_t(id % size_.at(level))));
       id = id / size_.at(level);
       final_pattern.insert(final_pattern.end(), permuted_infix.begin(), permuted_infix.end());
     }
@@ -325,7 +450,8 @@ RubyPermutationSpace::RubyPermutationSpace(const problem::Workload& workload) :
 
 void RubyPermutationSpace::InitLevel(uint64_t level, std::vector<problem::Shape::FlattenedDimensionID> user_prefix,
                                  std::vector<problem::Shape::FlattenedDimensionID> user_suffix,
-                                 std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions)
+                                 std::vector<problem::Shape::FlattenedDimensionID> pruned_dimensions,
+                                 bool reuse_classes)
 {
   // avoid handling user_suffix as it is useless in Ruby
   assert((user_suffix == user_prefix) || (user_suffix.size() == 0));
@@ -357,6 +483,19 @@ void RubyPermutationSpace::InitLevel(uint64_t level, std::vector<problem::Shape:
 
   ruby_patterns_[level] = { baked_prefix, permutable_suffix };
   size_[level] = factoradic_.Factorial(permutable_suffix.size());
+  representatives_.erase(level);
+
+  if (reuse_classes)
+  {
+    std::vector<problem::Shape::FlattenedDimensionID> inner(baked_prefix.begin() + pruned_dimensions.size(),
+                                                            baked_prefix.end());
+    auto& representatives = ReuseClassRepresentatives(inner, permutable_suffix, {});
+    if (!representatives.empty())
+    {
+      representatives_[level] = representatives;
+      size_[level] = representatives.size();
+    }
+  }
 }
 
 std::vector<std::vector<problem::Shape::FlattenedDimensionID>>
@@ -375,7 +514,7 @@ RubyPermutationSpace::GetPatterns(uint128_t id)
     {
       std::vector<problem::Shape::FlattenedDimensionID> permuted_suffix = pattern.permutable_suffix;
       factoradic_.Permute(permuted_suffix.data(), permuted_suffix.size(),
-                          std::uint64_t(id % size_.at(level)));
+                          PermutationIndex(level, std::uint64_t(id % size_.at(level))));
       id = id / size_.at(level);
       std::vector<problem::Shape::FlattenedDimensionID> final_pattern = pattern.baked_prefix;
       final_pattern.insert(final_pattern.end(), permuted_suffix.begin(), permuted_suffix.end());
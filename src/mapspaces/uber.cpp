@@ -25,6 +25,10 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cmath>
+#include <limits>
+#include <set>
+
 #include "mapspaces/uber.hpp"
 
 namespace mapspace
@@ -45,6 +49,7 @@ Uber::Uber(
   model::Engine::Specs arch_specs,
   const problem::Workload& workload,
   bool filter_spatial_fanout,
+  bool permutation_classes,
   bool skip_init) :
     
     MapSpace(arch_specs, workload),
@@ -58,7 +63,8 @@ Uber::Uber(
     num_parent_splits_(0),
     arch_props_(arch_specs),
     constraints_(arch_props_, workload),
-    filter_spatial_fanout_(filter_spatial_fanout)
+    filter_spatial_fanout_(filter_spatial_fanout),
+    permutation_classes_(permutation_classes)
 {
   if (!skip_init)
   {
@@ -256,9 +262,11 @@ void Uber::InitLoopPermutationSpace(std::map<unsigned, std::vector<problem::Shap
       // user-provided pattern. If this pattern is empty or incomplete,
       // it exposes a permutation space. This logic is handled by the
       // permutation space object itself.
+      // Reuse classes need the unit-factor dimensions to have been pruned.
       auto it = pruned_dimensions.find(level);
       if (it != pruned_dimensions.end())
-        permutation_space_.InitLevel(level, user_prefix, user_suffix, it->second);
+        permutation_space_.InitLevel(level, user_prefix, user_suffix, it->second,
+                                     permutation_classes_ && !arch_props_.IsSpatial(level));
       else
         permutation_space_.InitLevel(level, user_prefix, user_suffix);
     }
@@ -458,6 +466,189 @@ void Uber::InitPruned(uint128_t index_factorization_id)
   InitSpatialSpace(unit_factors);
 }
 
+//
+// IndexFactorizationBound()
+//   Lower bound on the cost of every mapping with this index factorization.
+//   Every operation runs on the arithmetic units, at most one per utilized
+//   arithmetic instance per cycle. A tensor kept in the backing store is read
+//   from it (or, if it is an output, updated into it) once for every iteration
+//   of the backing level's irrelevant temporal loops that sit outside its
+//   innermost relevant one; inner levels and bypass choices can only add to
+//   that. The backing level's loop order is chosen to minimize the total.
+//
+CostBound Uber::IndexFactorizationBound(uint128_t index_factorization_id)
+{
+  CostBound bound;
+
+  auto shape = workload_.GetShape();
+  unsigned num_dims = shape->NumFlattenedDimensions;
+  unsigned backing_level = arch_specs_.topology.NumStorageLevels() - 1;
+
+  // Find global index factorization id (across all splits).
+  uint128_t mapping_index_factorization_id = index_factorization_id * num_parent_splits_ + split_id_;
+
+  // Walk the factors the way AssignIndexFactors() clips them.
+  double total_ops = 1;
+  double max_parallelism = 1;
+  bool perfect = true;
+  std::vector<unsigned long> backing_factors(num_dims, 1);
+  for (unsigned idim = 0; idim < num_dims; idim++)
+  {
+    auto dim = problem::Shape::FlattenedDimensionID(idim);
+    unsigned long remaining = workload_.GetFlattenedBound(dim);
+    total_ops *= remaining;
+    for (unsigned level = 0; level < arch_props_.TilingLevels(); level++)
+    {
+      auto factor = std::min(index_factorization_space_.GetFactor(mapping_index_factorization_id, dim, level),
+                             remaining);
+      perfect &= (remaining % factor == 0);
+      remaining = (remaining + factor - 1) / factor;
+
+      if (arch_props_.IsSpatial(level))
+        max_parallelism *= factor;
+      else if (arch_props_.TilingToStorage(level) == backing_level)
+        backing_factors[idim] *= factor;
+    }
+  }
+
+  bound.cycles = std::ceil(total_ops / max_parallelism);
+
+  auto& compute_energy = arch_specs_.topology.GetArithmeticLevel()->op_energy_map;
+  auto compute = compute_energy.find("random_compute");
+  if (compute != compute_energy.end())
+  {
+    bound.energy = total_ops * compute->second;
+  }
+
+  // Per-instance energies are spread over the utilized instances, which this
+  // bound does not model, so only single-instance backing stores count.
+  auto backing = arch_specs_.topology.GetStorageLevel(backing_level);
+  if (shape->UsesFlattening || !backing->instances.IsSpecified() || backing->instances.Get() != 1)
+  {
+    return bound;
+  }
+
+  auto access_energy = [&](const std::string& op_name)
+  {
+    auto it = backing->op_energy_map.find(op_name);
+    return it == backing->op_energy_map.end() ? 0.0 : it->second / double(backing->block_size.Get());
+  };
+
+  // The backing level's loops with a non-unit factor.
+  std::vector<unsigned> loop_dims;
+  for (unsigned idim = 0; idim < num_dims; idim++)
+  {
+    if (backing_factors[idim] > 1)
+    {
+      loop_dims.push_back(idim);
+    }
+  }
+  bool permute = perfect && loop_dims.size() <= 16;
+  unsigned num_loops = permute ? loop_dims.size() : 0;
+  unsigned all_loops = (1u << num_loops) - 1;
+
+  // Tensors whose every rank is indexed by a single dimension fetch disjoint
+  // tiles, so each sweep of their relevant loops reads all of them. With
+  // sliding windows consecutive sweeps may overlap, so those tensors only get
+  // their compulsory accesses.
+  std::vector<double> tensor_cost;
+  std::vector<unsigned> relevant_loops;
+  for (unsigned pvi = 0; pvi < shape->NumDataSpaces; pvi++)
+  {
+    auto pv = problem::Shape::DataSpaceID(pvi);
+
+    bool kept = true;
+    for (auto& datatype_bypass_nest: datatype_bypass_nest_space_)
+    {
+      kept &= datatype_bypass_nest.at(pvi).test(backing_level);
+    }
+    if (!kept)
+    {
+      continue;
+    }
+
+    std::set<unsigned> dims;
+    bool single_dim_ranks = true;
+    for (auto& expression: shape->Projections.at(pvi))
+    {
+      if (expression.size() != 1 ||
+          (expression.front().first != shape->NumCoefficients &&
+           workload_.GetCoefficient(expression.front().first) == 0))
+      {
+        single_dim_ranks = false;
+        break;
+      }
+      dims.insert(expression.front().second);
+    }
+    if (!single_dim_ranks)
+    {
+      continue;
+    }
+
+    double size = 1;
+    unsigned relevant = 0;
+    for (auto idim: dims)
+    {
+      size *= workload_.GetFlattenedBound(problem::Shape::FlattenedDimensionID(idim));
+    }
+    for (unsigned i = 0; i < num_loops; i++)
+    {
+      if (dims.count(loop_dims[i]))
+      {
+        relevant |= (1u << i);
+      }
+    }
+
+    bool is_output = shape->IsReadWriteDataSpace.at(pv);
+    tensor_cost.push_back(size * access_energy(is_output ? "random_update" : "random_read"));
+    relevant_loops.push_back(relevant);
+  }
+
+  // products[m]: product of the factors of the loops in m.
+  std::vector<double> products(1u << num_loops, 1);
+  for (unsigned m = 1; m <= all_loops; m++)
+  {
+    unsigned i = __builtin_ctz(m);
+    products[m] = products[m & (m - 1)] * backing_factors[loop_dims[i]];
+  }
+
+  // best[s]: cheapest accesses of the tensors whose innermost relevant loop
+  // is among the loops in s, which are placed innermost.
+  std::vector<double> best(1u << num_loops, std::numeric_limits<double>::infinity());
+  best[0] = 0;
+  for (unsigned s = 1; s <= all_loops; s++)
+  {
+    for (unsigned i = 0; i < num_loops; i++)
+    {
+      unsigned inner = s & ~(1u << i);
+      if (inner == s || best[inner] >= best[s])
+      {
+        continue;
+      }
+      double cost = best[inner];
+      for (unsigned t = 0; t < tensor_cost.size(); t++)
+      {
+        if ((relevant_loops[t] & (1u << i)) && !(relevant_loops[t] & inner))
+        {
+          cost += tensor_cost[t] * products[all_loops & ~s & ~relevant_loops[t]];
+        }
+      }
+      best[s] = std::min(best[s], cost);
+    }
+  }
+
+  bound.energy += best[all_loops];
+  for (unsigned t = 0; t < tensor_cost.size(); t++)
+  {
+    if (!relevant_loops[t])
+    {
+      bound.energy += tensor_cost[t];
+    }
+  }
+
+  return bound;
+}
+
 //
 // Split the mapspace (used for parallelization).
 //
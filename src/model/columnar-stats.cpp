@@ -0,0 +1,242 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "model/columnar-stats.hpp"
+
+namespace model
+{
+
+namespace
+{
+
+constexpr std::size_t kHeaderBytes = 32;
+constexpr std::size_t kEntryBytes = 24;
+
+// The format is little-endian; so are all hosts we build for, which lets
+// both sides copy integers and values as they are laid out in memory.
+static_assert(sizeof(double) == 8, "ColumnarStats: float64 values expected");
+
+template <class T>
+void Put(std::ostream& out, T value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+T Get(const char* p)
+{
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  return value;
+}
+
+std::uint64_t AlignUp(std::uint64_t offset)
+{
+  return (offset + 7) & ~std::uint64_t(7);
+}
+
+} // namespace
+
+//--------------------------------------------//
+//                   Writer                   //
+//--------------------------------------------//
+
+constexpr char ColumnarStats::kMagic[8];
+
+void ColumnarStats::Add(const std::string& name, std::vector<double> values)
+{
+  columns_.emplace_back(name, std::move(values));
+}
+
+void ColumnarStats::Write(std::ostream& out) const
+{
+  std::uint64_t names_bytes = 0;
+  for (auto& column : columns_)
+  {
+    names_bytes += column.first.size();
+  }
+
+  std::uint64_t names_offset = kHeaderBytes + kEntryBytes * columns_.size();
+  std::uint64_t values_offset = AlignUp(names_offset + names_bytes);
+
+  out.write(kMagic, sizeof(kMagic));
+  Put<std::uint32_t>(out, kVersion);
+  Put<std::uint32_t>(out, columns_.size());
+  Put<std::uint64_t>(out, names_offset);
+  Put<std::uint64_t>(out, values_offset);
+
+  std::uint32_t name_pos = 0;
+  std::uint64_t value_pos = 0;
+  for (auto& column : columns_)
+  {
+    Put<std::uint32_t>(out, name_pos);
+    Put<std::uint32_t>(out, column.first.size());
+    Put<std::uint64_t>(out, value_pos);
+    Put<std::uint64_t>(out, column.second.size());
+    name_pos += column.first.size();
+    value_pos += column.second.size();
+  }
+
+  for (auto& column : columns_)
+  {
+    out.write(column.first.data(), column.first.size());
+  }
+  for (auto pad = names_offset + names_bytes; pad < values_offset; pad++)
+  {
+    out.put('\0');
+  }
+
+  for (auto& column : columns_)
+  {
+    out.write(reinterpret_cast<const char*>(column.second.data()),
+              sizeof(double) * column.second.size());
+  }
+}
+
+//--------------------------------------------//
+//                   Reader                   //
+//--------------------------------------------//
+
+ColumnarStatsReader::ColumnarStatsReader(const std::string& path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("ColumnarStats: cannot open " + path);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || std::size_t(st.st_size) < kHeaderBytes)
+  {
+    close(fd);
+    throw std::runtime_error("ColumnarStats: " + path + " is truncated");
+  }
+  length_ = st.st_size;
+
+  void* map = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    throw std::runtime_error("ColumnarStats: cannot map " + path);
+  }
+  data_ = static_cast<const char*>(map);
+
+  version_ = Get<std::uint32_t>(data_ + 8);
+  num_columns_ = Get<std::uint32_t>(data_ + 12);
+  names_offset_ = Get<std::uint64_t>(data_ + 16);
+  values_offset_ = Get<std::uint64_t>(data_ + 24);
+
+  std::string error;
+  if (std::memcmp(data_, ColumnarStats::kMagic, sizeof(ColumnarStats::kMagic)) != 0)
+  {
+    error = " is not a stats file";
+  }
+  else if (version_ > ColumnarStats::kVersion)
+  {
+    error = " has unsupported version " + std::to_string(version_);
+  }
+  else if (kHeaderBytes + kEntryBytes * num_columns_ > names_offset_ ||
+           names_offset_ > values_offset_ || values_offset_ > length_)
+  {
+    error = " is truncated";
+  }
+  else
+  {
+    auto values_bytes = length_ - values_offset_;
+    for (std::size_t column = 0; column < num_columns_ && error.empty(); column++)
+    {
+      auto entry = Entry(column);
+      auto name_end = names_offset_ + Get<std::uint32_t>(entry) + Get<std::uint32_t>(entry + 4);
+      auto value_end = Get<std::uint64_t>(entry + 8) + Get<std::uint64_t>(entry + 16);
+      if (name_end > values_offset_ || value_end > values_bytes / sizeof(double))
+      {
+        error = " is truncated";
+      }
+    }
+  }
+
+  if (!error.empty())
+  {
+    munmap(const_cast<char*>(data_), length_);
+    throw std::runtime_error("ColumnarStats: " + path + error);
+  }
+}
+
+ColumnarStatsReader::~ColumnarStatsReader()
+{
+  munmap(const_cast<char*>(data_), length_);
+}
+
+const char* ColumnarStatsReader::Entry(std::size_t column) const
+{
+  return data_ + kHeaderBytes + kEntryBytes * column;
+}
+
+std::string ColumnarStatsReader::Name(std::size_t column) const
+{
+  auto entry = Entry(column);
+  return std::string(data_ + names_offset_ + Get<std::uint32_t>(entry),
+                     Get<std::uint32_t>(entry + 4));
+}
+
+std::size_t ColumnarStatsReader::Size(std::size_t column) const
+{
+  return Get<std::uint64_t>(Entry(column) + 16);
+}
+
+const double* ColumnarStatsReader::Values(std::size_t column) const
+{
+  // The value block is 8-byte aligned in the file and mmap() is page
+  // aligned, so the values can be read in place.
+  return reinterpret_cast<const double*>(
+    data_ + values_offset_ + sizeof(double) * Get<std::uint64_t>(Entry(column) + 8));
+}
+
+std::size_t ColumnarStatsReader::Find(const std::string& name) const
+{
+  for (std::size_t column = 0; column < num_columns_; column++)
+  {
+    auto entry = Entry(column);
+    auto length = Get<std::uint32_t>(entry + 4);
+    if (length == name.size() &&
+        std::memcmp(data_ + names_offset_ + Get<std::uint32_t>(entry), name.data(), length) == 0)
+    {
+      return column;
+    }
+  }
+  return num_columns_;
+}
+
+} // namespace model
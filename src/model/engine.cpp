@@ -71,11 +71,12 @@ std::vector<EvalStatus> Engine::PreEvaluationCheck(const Mapping& mapping, probl
   return topology_.PreEvaluationCheck(mapping, &nest_analysis_, sparse_optimizations, break_on_failure);
 }
 
-std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& workload, layout::Layouts layout, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure)
+std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& workload, const layout::Layouts& layout, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure,
+                                         const EvalBound& bound)
 {
   nest_analysis_.Init(&workload, &mapping.loop_nest, layout, mapping.fanoutX_map, mapping.fanoutY_map);
     
-  auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, sparse_optimizations, break_on_failure);
+  auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, sparse_optimizations, break_on_failure, bound);
 
   is_evaluated_ = std::accumulate(eval_status.begin(), eval_status.end(), true,
                                   [](bool cur, const EvalStatus& status)
@@ -83,11 +84,12 @@ std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& wo
 
   return eval_status;
 }
-std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure)
+std::vector<EvalStatus> Engine::Evaluate(Mapping& mapping, problem::Workload& workload, sparse::SparseOptimizationInfo* sparse_optimizations, bool break_on_failure,
+                                         const EvalBound& bound)
 {
   nest_analysis_.Init(&workload, &mapping.loop_nest, mapping.fanoutX_map, mapping.fanoutY_map);
     
-  auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, sparse_optimizations, break_on_failure);
+  auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, sparse_optimizations, break_on_failure, bound);
 
   is_evaluated_ = std::accumulate(eval_status.begin(), eval_status.end(), true,
                                   [](bool cur, const EvalStatus& status)
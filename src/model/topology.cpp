@@ -32,6 +32,8 @@
 #include "model/topology.hpp"
 #include "model/network-legacy.hpp"
 #include "model/network-factory.hpp"
+#include "model/network-reduction-tree.hpp"
+#include "model/network-simple-multicast.hpp"
 #include "sparse-analysis/sparse-analysis.hpp"
 #include "workload/workload.hpp"
 
@@ -1257,7 +1259,7 @@ std::vector<EvalStatus> Topology::PreEvaluationCheck(const Mapping& mapping,
   }
 
   auto masks = tiling::TransposeMasks(mapping.datatype_bypass_nest, workload);
-  auto working_set_sizes = analysis->GetWorkingSetSizes_LTW();
+  const auto& working_set_sizes = analysis->GetWorkingSetSizes_LTW();
   sparse::CompressionInfo storage_compression_info = sparse_optimizations->compression_info;
 
   for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
@@ -1291,7 +1293,8 @@ std::vector<EvalStatus> Topology::PreEvaluationCheck(const Mapping& mapping,
 std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
                                            analysis::NestAnalysis* analysis,
                                            sparse::SparseOptimizationInfo* sparse_optimizations,
-                                           bool break_on_failure)
+                                           bool break_on_failure,
+                                           const EvalBound& bound)
 {
   assert(is_specced_);
   Reset();
@@ -1316,7 +1319,7 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
 
   problem::Workload* workload = analysis->GetWorkload();
   workload_ = workload;
-  layout::Layouts layout = analysis->GetLayout();
+  const layout::Layouts& layout = analysis->GetLayout();
 
   std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
   bool valid = tiling::CheckMaskValidity(mapping.datatype_bypass_nest, workload);
@@ -1342,15 +1345,16 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
                                                 break_on_failure);
   if (break_on_failure && !success) { return eval_status; }
 
-  // Compute working-set tile hierarchy for the nest.
-  analysis::CompoundTileNest tile_info_nest;
-  problem::PerDataSpace<std::vector<analysis::DataMovementInfo>> ws_tiles;
+  // Compute working-set tile hierarchy for the nest. The analysis keeps these
+  // for as long as the nest is unchanged, so mappings that differ from the
+  // previous one only in bypass read them in place; everything from
+  // CollapseTiles() on is redone per mapping.
+  const analysis::CompoundComputeNest* compute_info_nest = nullptr;
+  const analysis::CompoundDataMovementNest* data_movement_info_nest = nullptr;
   try
   {
-    ws_tiles = analysis->GetWorkingSets();
-    // construct a summaried tileinfo with both datamovement info and compute info
-    tile_info_nest.compound_compute_info_nest = analysis->GetComputeInfo();
-    tile_info_nest.compound_data_movement_info_nest = ws_tiles;
+    compute_info_nest = &analysis->GetComputeInfo();
+    data_movement_info_nest = &analysis->GetWorkingSets();
   }
   catch (std::runtime_error& e)
   {
@@ -1361,7 +1365,7 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
 
 
   // Ugh... FIXME.
-  auto compute_cycles = analysis->GetComputeInfo()[0].accesses; //innermost level
+  auto compute_cycles = compute_info_nest->at(0).accesses; //innermost level
 
   // Create a mask indicating which levels support distributed multicast.
   tiling::CompoundMaskNest distribution_supported(workload->GetShape()->NumDataSpaces);
@@ -1380,7 +1384,8 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
 
   // Collapse tiles into a specified number of tiling levels. The solutions are
   // received in a set of per-problem::Shape::DataSpaceID arrays.
-  auto collapsed_tiles = tiling::CollapseTiles(tile_info_nest,
+  auto collapsed_tiles = tiling::CollapseTiles(*data_movement_info_nest,
+                                               *compute_info_nest,
                                                specs_.NumStorageLevels(),
                                                mapping.datatype_bypass_nest,
                                                distribution_supported,
@@ -1405,7 +1410,7 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
   }
 
   // Transpose the tiles into level->datatype/level->optype structure.
-  auto tiles = tiling::TransposeTiles(collapsed_tiles, workload);
+  auto tiles = tiling::TransposeTiles(std::move(collapsed_tiles), workload);
   assert(tiles.size() == NumStorageLevels());
 
   if (!break_on_failure || success_accum)
@@ -1427,6 +1432,21 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
     compute_cycles = GetArithmeticLevel()->Cycles();
   uint64_t total_cycles = compute_cycles;
 
+  // Branch-and-bound: the energy and cycles accumulated so far are lower
+  // bounds on the final ones (ComputeStats() only adds to them).
+  auto dominated = [&](double energy, std::uint64_t cycles)
+  {
+    if (!success_accum || !bound.Exceeded(energy, cycles))
+      return false;
+    std::fill(eval_status.begin(), eval_status.end(),
+              EvalStatus({ .success = false, .fail_reason = "dominated by bound", .dominated = true }));
+    return true;
+  };
+
+  double compute_energy = success_accum ? GetArithmeticLevel()->Energy() : 0;
+  if (dominated(compute_energy, total_cycles))
+    return eval_status;
+
   int current_storage_boundary = 0;
   std::vector<loop::Descriptor> subtile_mapping_loopnest;
   std::vector<loop::Descriptor> subtile_mapping_parallelism;
@@ -1482,6 +1502,11 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
         break;
     }
 
+    // Buffer energy is only final after FinalizeBufferEnergy() below, so
+    // until then only the cycles tighten the bound.
+    if (dominated(compute_energy, total_cycles))
+      return eval_status;
+
     for(unsigned i = current_storage_boundary; i <= mapping.loop_nest.storage_tiling_boundaries[storage_level_id]; i++)
     {
      // For subtile shape
@@ -1529,6 +1554,17 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
       storage_level->ComputeLeaksPerCycle();
       storage_level->FinalizeBufferEnergy(total_cycles);
     }
+
+    if (success_accum)
+    {
+      double energy = 0;
+      for (auto level : levels_)
+      {
+        energy += level->Energy(workload_->GetShape()->NumDataSpaces);
+      }
+      if (dominated(energy, total_cycles))
+        return eval_status;
+    }
   }
 
   unsigned int numConnections = NumStorageLevels();
@@ -1574,6 +1610,46 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
   return eval_status;
 }
 
+void Topology::ExportStats(ColumnarStats& out) const
+{
+  out.Add("topology.energy", stats_.energy);
+  out.Add("topology.area", stats_.area);
+  out.Add("topology.cycles", stats_.cycles);
+  out.Add("topology.utilization", stats_.utilization);
+  out.Add("topology.algorithmic_computes", stats_.algorithmic_computes);
+  out.Add("topology.actual_computes", stats_.actual_computes);
+  out.Add("topology.last_level_accesses", stats_.last_level_accesses);
+
+  for (auto& level : levels_)
+  {
+    if (auto buffer = std::dynamic_pointer_cast<BufferLevel>(level))
+    {
+      out.AddObject(buffer->Name(), *buffer);
+    }
+    else if (auto arithmetic = std::dynamic_pointer_cast<ArithmeticUnits>(level))
+    {
+      out.AddObject(arithmetic->Name(), *arithmetic);
+    }
+  }
+
+  for (auto& network_kv : networks_)
+  {
+    auto& network = network_kv.second;
+    if (auto legacy = std::dynamic_pointer_cast<LegacyNetwork>(network))
+    {
+      out.AddObject(network_kv.first, *legacy);
+    }
+    else if (auto multicast = std::dynamic_pointer_cast<SimpleMulticastNetwork>(network))
+    {
+      out.AddObject(network_kv.first, *multicast);
+    }
+    else if (auto tree = std::dynamic_pointer_cast<ReductionTreeNetwork>(network))
+    {
+      out.AddObject(network_kv.first, *tree);
+    }
+  }
+}
+
 void Topology::ComputeStats(bool eval_success)
 {
   if (eval_success)
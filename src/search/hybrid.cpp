@@ -30,18 +30,20 @@
 namespace search
 {
 
-HybridSearch::HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id) :
+HybridSearch::HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                           const IndexFactorizationPruner& pruner) :
     SearchAlgorithm(),
     mapspace_(mapspace),
     id_(id),
     if_pgen_(mapspace_->Size(mapspace::Dimension::IndexFactorization)),
+    if_perm_(mapspace_->Size(mapspace::Dimension::IndexFactorization), id),
+    pruner_(pruner),
+    next_ranked_(0),
     state_(State::Ready),
     valid_mappings_(0),
     eval_fail_count_(0),
     best_cost_(0)
 {
-  (void) id_;
-    
   filter_revisits_ = false;
   config.lookupValue("filter_revisits", filter_revisits_);    
     
@@ -59,8 +61,15 @@ HybridSearch::HybridSearch(config::CompoundConfigNode config, mapspace::MapSpace
   }
   else
   {
+    if (filter_revisits_ && pruner_.Enabled() &&
+        mapspace_->Size(mapspace::Dimension::IndexFactorization) <= IndexFactorizationPruner::kMaxRanked)
+    {
+      ranked_ = pruner_.Rank();
+      iterator_[unsigned(mapspace::Dimension::IndexFactorization)] = ranked_.at(next_ranked_++).second;
+    }
+
     // Prune the mapspace for the first time.
-    mapspace_->InitPruned(0);
+    mapspace_->InitPruned(iterator_[unsigned(mapspace::Dimension::IndexFactorization)]);
   }
 
 #ifdef DUMP_COSTS
@@ -84,27 +93,43 @@ bool HybridSearch::IncrementRecursive_(int position)
   // the others.
   if (dim == mapspace::Dimension::IndexFactorization)
   {
-    // Throw a random number to get the next index factorization.
+    // Throw a random number to get the next index factorization, skipping
+    // those that can't beat the incumbent.
     uint128_t n;
-    while (true)
+    if (!ranked_.empty())
+    {
+      // Ranked best bound first: once one is dominated, so are the rest.
+      if (next_ranked_ == ranked_.size())
+      {
+        return false;
+      }
+      if (pruner_.Dominated(ranked_[next_ranked_].first))
+      {
+        pruner_.CountPruned(ranked_.size() - next_ranked_);
+        next_ranked_ = ranked_.size();
+        return false;
+      }
+      n = ranked_[next_ranked_++].second;
+    }
+    else if (filter_revisits_)
     {
-      n = if_pgen_.Next();
-      if (filter_revisits_)
+      unsigned pruned = 0;
+      do
       {
-        if (visited_.size() == mapspace_->Size(mapspace::Dimension::IndexFactorization))
+        if (if_perm_.Exhausted())
         {
           return false;
         }
-        else if (visited_.find(n) == visited_.end())
-        {
-          visited_.insert(n);
-          break;
-        }
-      }
-      else // do not filter revisits
+        n = if_perm_.Next();
+      } while (pruned++ < IndexFactorizationPruner::kMaxConsecutivePrunes && pruner_.Prune(n));
+    }
+    else
+    {
+      unsigned pruned = 0;
+      do
       {
-        break;
-      }
+        n = if_pgen_.Next();
+      } while (pruned++ < IndexFactorizationPruner::kMaxConsecutivePrunes && pruner_.Prune(n));
     }
 
     iterator_[unsigned(dim)] = n;
@@ -185,6 +210,8 @@ void HybridSearch::Report(Status status, double cost)
       best_cost_ = cost;
     else
       best_cost_ = std::min(best_cost_, cost);
+
+    pruner_.UpdateIncumbent(cost);
   }
   else if (status == Status::MappingConstructionFailure)
   {
@@ -237,4 +264,14 @@ void HybridSearch::Report(Status status, double cost)
   }
 }
 
+void HybridSearch::UpdateIncumbent(double cost)
+{
+  pruner_.UpdateIncumbent(cost);
+}
+
+void HybridSearch::PrintStats(std::ostream& out) const
+{
+  pruner_.PrintStats(out);
+}
+
 } // namespace search
@@ -0,0 +1,122 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "search/if-pruner.hpp"
+
+namespace search
+{
+
+// Mappings within this fraction of the incumbent may still win on a
+// secondary metric (see the mapper's betterness tolerance).
+static const double incumbent_tolerance = 0.001;
+
+IndexFactorizationPruner::IndexFactorizationPruner(mapspace::MapSpace* mapspace, const std::string& metric) :
+    mapspace_(mapspace),
+    metric_(model::EvalBound::Metric::Energy),
+    incumbent_(std::numeric_limits<double>::infinity()),
+    scored_(0),
+    pruned_(0)
+{
+  if (metric == "delay")
+    metric_ = model::EvalBound::Metric::Delay;
+  else if (metric == "edp")
+    metric_ = model::EvalBound::Metric::EDP;
+}
+
+bool IndexFactorizationPruner::SupportsMetric(const std::string& metric)
+{
+  return metric == "energy" || metric == "delay" || metric == "edp";
+}
+
+void IndexFactorizationPruner::UpdateIncumbent(double cost)
+{
+  incumbent_ = std::min(incumbent_, cost * (1 + incumbent_tolerance));
+}
+
+double IndexFactorizationPruner::Score(uint128_t index_factorization_id)
+{
+  assert(Enabled());
+  scored_++;
+
+  auto bound = mapspace_->IndexFactorizationBound(index_factorization_id);
+  switch (metric_)
+  {
+    case model::EvalBound::Metric::Energy: return bound.energy;
+    case model::EvalBound::Metric::Delay: return bound.cycles;
+    case model::EvalBound::Metric::EDP: return bound.energy * bound.cycles;
+  }
+  return 0;
+}
+
+bool IndexFactorizationPruner::Dominated(double score) const
+{
+  return score > incumbent_;
+}
+
+bool IndexFactorizationPruner::Prune(uint128_t index_factorization_id)
+{
+  if (!Enabled() || !Dominated(Score(index_factorization_id)))
+  {
+    return false;
+  }
+  pruned_++;
+  return true;
+}
+
+void IndexFactorizationPruner::CountPruned(std::uint64_t count)
+{
+  pruned_ += count;
+}
+
+std::vector<std::pair<double, uint128_t>> IndexFactorizationPruner::Rank()
+{
+  std::vector<std::pair<double, uint128_t>> ranked;
+  auto size = mapspace_->Size(mapspace::Dimension::IndexFactorization);
+  for (uint128_t id = 0; id < size; id++)
+  {
+    ranked.emplace_back(Score(id), id);
+  }
+  std::stable_sort(ranked.begin(), ranked.end(),
+                   [](const std::pair<double, uint128_t>& a, const std::pair<double, uint128_t>& b)
+                   { return a.first < b.first; });
+  return ranked;
+}
+
+void IndexFactorizationPruner::PrintStats(std::ostream& out) const
+{
+  if (Enabled())
+  {
+    out << "index factorization bounds: " << scored_ << " scored, "
+        << pruned_ << " pruned.";
+  }
+}
+
+} // namespace search
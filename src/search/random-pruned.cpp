@@ -30,12 +30,14 @@
 namespace search
 {
 
-RandomPrunedSearch::RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id) :
+RandomPrunedSearch::RandomPrunedSearch(config::CompoundConfigNode config, mapspace::MapSpace* mapspace, unsigned id,
+                                       const IndexFactorizationPruner& pruner) :
     SearchAlgorithm(),
     mapspace_(mapspace),
     id_(id),
     if_pgen_(mapspace_->Size(mapspace::Dimension::IndexFactorization)),
     lp_pgen_(mapspace_->Size(mapspace::Dimension::LoopPermutation)),
+    pruner_(pruner),
     state_(State::Ready),
     valid_mappings_(0),
     eval_fail_count_(0),
@@ -97,8 +99,14 @@ bool RandomPrunedSearch::IncrementRecursive_(int position)
 
   if (dim == mapspace::Dimension::IndexFactorization)
   {
-    // Throw a random number to get the next index factorization.
-    iterator_[unsigned(dim)] = if_pgen_.Next();
+    // Throw a random number to get the next index factorization, skipping
+    // those that can't beat the incumbent.
+    unsigned pruned = 0;
+    do
+    {
+      iterator_[unsigned(dim)] = if_pgen_.Next();
+    } while (pruned++ < IndexFactorizationPruner::kMaxConsecutivePrunes &&
+             pruner_.Prune(iterator_[unsigned(dim)]));
       
     // We just changed the index factorization. Prune the sub-mapspace
     // for this specific factorization index.
@@ -205,6 +213,8 @@ void RandomPrunedSearch::Report(Status status, double cost)
       best_cost_ = cost;
     else
       best_cost_ = std::min(best_cost_, cost);
+
+    pruner_.UpdateIncumbent(cost);
   }
   else if (status == Status::MappingConstructionFailure)
   {
@@ -256,4 +266,14 @@ void RandomPrunedSearch::Report(Status status, double cost)
   }
 }
 
+void RandomPrunedSearch::UpdateIncumbent(double cost)
+{
+  pruner_.UpdateIncumbent(cost);
+}
+
+void RandomPrunedSearch::PrintStats(std::ostream& out) const
+{
+  pruner_.PrintStats(out);
+}
+
 } // namespace search
@@ -42,12 +42,28 @@ namespace search
 
 SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
                                    mapspace::MapSpace* mapspace,
-                                   unsigned id)
+                                   unsigned id,
+                                   const std::string& metric,
+                                   bool dense)
 {
   SearchAlgorithm* search = nullptr;
   
   std::string search_alg = "hybrid";
   config.lookupValue("algorithm", search_alg);
+
+  // The bounds are only valid for dense evaluations of a metric they cover.
+  bool prune_index_factorizations = false;
+  config.lookupValue("prune_index_factorizations", prune_index_factorizations);
+  if (prune_index_factorizations && (!dense || !IndexFactorizationPruner::SupportsMetric(metric)))
+  {
+    if (id == 0)
+    {
+      std::cerr << "WARNING: prune_index_factorizations ignored: requires a dense "
+                << "evaluation and an energy, delay or edp metric." << std::endl;
+    }
+    prune_index_factorizations = false;
+  }
+  IndexFactorizationPruner pruner(prune_index_factorizations ? mapspace : nullptr, metric);
     
   if (search_alg == "random")
   {
@@ -63,11 +79,11 @@ SearchAlgorithm* ParseAndConstruct(config::CompoundConfigNode config,
   }
   else if (search_alg == "hybrid")
   {
-    search = new HybridSearch(config, mapspace, id);
+    search = new HybridSearch(config, mapspace, id, pruner);
   }
   else if (search_alg == "random_pruned")
   {
-    search = new RandomPrunedSearch(config, mapspace, id);
+    search = new RandomPrunedSearch(config, mapspace, id, pruner);
   }
   else
   {
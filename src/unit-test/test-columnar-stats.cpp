@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "model/columnar-stats.hpp"
+
+namespace
+{
+
+struct LevelStats
+{
+  double energy = 2.5;
+  problem::PerDataSpace<std::uint64_t> reads{1, 2, 3};
+  model::Attribute<unsigned> instances{16};
+  model::Attribute<unsigned> meshX;
+  std::string name = "Buffer";
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int)
+  {
+    ar& BOOST_SERIALIZATION_NVP(energy);
+    ar& BOOST_SERIALIZATION_NVP(reads);
+    ar& BOOST_SERIALIZATION_NVP(instances);
+    ar& BOOST_SERIALIZATION_NVP(meshX);
+    ar& BOOST_SERIALIZATION_NVP(name);
+  }
+};
+
+class Level
+{
+  LevelStats stats_;
+
+  friend class boost::serialization::access;
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int)
+  {
+    ar& BOOST_SERIALIZATION_NVP(stats_);
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestColumnarStatsRoundTrip)
+{
+  model::ColumnarStats stats;
+  stats.Add("topology.cycles", 42);
+  stats.AddObject("Buffer", Level());
+
+  std::string path = "test-columnar-stats.bin";
+  {
+    std::ofstream file(path, std::ios::binary);
+    stats.Write(file);
+  }
+
+  {
+    model::ColumnarStatsReader reader(path);
+    BOOST_CHECK_EQUAL(reader.Version(), model::ColumnarStats::kVersion);
+    // Strings and unspecified attributes get no column.
+    BOOST_CHECK_EQUAL(reader.NumColumns(), 4);
+
+    auto reads = reader.Find("Buffer.stats_.reads");
+    BOOST_REQUIRE(reads < reader.NumColumns());
+    BOOST_CHECK_EQUAL(reader.Size(reads), 3);
+    BOOST_CHECK_EQUAL(reader.Values(reads)[2], 3.0);
+
+    auto instances = reader.Find("Buffer.stats_.instances");
+    BOOST_REQUIRE(instances < reader.NumColumns());
+    BOOST_CHECK_EQUAL(reader.Values(instances)[0], 16.0);
+
+    BOOST_CHECK_EQUAL(reader.Values(reader.Find("topology.cycles"))[0], 42.0);
+    BOOST_CHECK_EQUAL(reader.Find("Buffer.stats_.meshX"), reader.NumColumns());
+  }
+
+  std::remove(path.c_str());
+}
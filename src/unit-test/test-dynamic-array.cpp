@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <boost/test/unit_test.hpp>
+
+#include "util/dynamic-array.hpp"
+
+namespace
+{
+
+template <class T>
+DynamicArray<T> Iota(std::size_t size)
+{
+  DynamicArray<T> a(size);
+  for (std::size_t i = 0; i < size; i++)
+  {
+    a[i] = T(i + 1);
+  }
+  return a;
+}
+
+template <class T>
+bool Equals(const DynamicArray<T>& a, std::size_t size)
+{
+  if (a.size() != size)
+  {
+    return false;
+  }
+  for (std::size_t i = 0; i < size; i++)
+  {
+    if (a[i] != T(i + 1))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+// Inline arrays must keep their data in the object; heap arrays must move
+// their buffer rather than copy it.
+BOOST_AUTO_TEST_CASE(TestDynamicArrayStorage)
+{
+  const std::size_t small = 3;
+  const std::size_t large = DynamicArray<std::uint64_t>::kInlineCapacity + 5;
+
+  auto a = Iota<std::uint64_t>(small);
+  auto object = reinterpret_cast<const char*>(&a);
+  auto data = reinterpret_cast<const char*>(a.data());
+  BOOST_CHECK(data >= object && data < object + sizeof(a));
+
+  auto b = Iota<std::uint64_t>(large);
+  auto buffer = b.data();
+  auto c = std::move(b);
+  BOOST_CHECK(c.data() == buffer);
+  BOOST_CHECK(Equals(c, large));
+  BOOST_CHECK_EQUAL(b.size(), 0);
+
+  auto d = std::move(a);
+  BOOST_CHECK(Equals(d, small));
+  BOOST_CHECK(d.data() != a.data());
+}
+
+BOOST_AUTO_TEST_CASE(TestDynamicArrayCopyAssignSwap)
+{
+  const std::size_t small = 3;
+  const std::size_t large = DynamicArray<std::uint64_t>::kInlineCapacity + 5;
+
+  for (auto lhs_size : { small, large })
+  {
+    for (auto rhs_size : { small, large })
+    {
+      auto lhs = Iota<std::uint64_t>(lhs_size);
+      auto rhs = Iota<std::uint64_t>(rhs_size);
+
+      DynamicArray<std::uint64_t> copy(rhs);
+      BOOST_CHECK(Equals(copy, rhs_size));
+
+      lhs = rhs;
+      BOOST_CHECK(Equals(lhs, rhs_size));
+      BOOST_CHECK(Equals(rhs, rhs_size));
+
+      auto x = Iota<std::uint64_t>(lhs_size);
+      auto y = Iota<std::uint64_t>(rhs_size);
+      swap(x, y);
+      BOOST_CHECK(Equals(x, rhs_size));
+      BOOST_CHECK(Equals(y, lhs_size));
+
+      auto z = Iota<std::uint64_t>(lhs_size);
+      z = std::move(y);
+      BOOST_CHECK(Equals(z, lhs_size));
+    }
+  }
+
+  // Bool and non-trivial element types.
+  DynamicArray<bool> flags(small);
+  flags[1] = true;
+  auto flags_copy = flags;
+  BOOST_CHECK(!flags_copy[0] && flags_copy[1] && !flags_copy[2]);
+
+  DynamicArray<std::string> names(small);
+  names[2] = "Outputs";
+  auto names_copy = names;
+  auto names_moved = std::move(names);
+  BOOST_CHECK_EQUAL(names_copy[2], "Outputs");
+  BOOST_CHECK_EQUAL(names_moved[2], "Outputs");
+}
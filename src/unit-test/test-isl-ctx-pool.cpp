@@ -0,0 +1,123 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "isl-wrapper/ctx-manager.hpp"
+
+namespace
+{
+
+struct JobContext
+{
+  std::thread::id thread;
+  isl_ctx* ctx;
+  bool result_ok;
+};
+
+// Builds a set in the calling thread's context and checks it against itself,
+// reparsed, so every job actually exercises its context.
+JobContext UseCtx()
+{
+  auto& ctx = GetIslCtx();
+  isl::set set(ctx, "{ [i] : 0 <= i < 10 }");
+  bool ok = set.is_equal(isl::set(ctx, "{ [i] : 0 <= i < 10 }")) &&
+            set.ctx().get() == ctx.get();
+  return { std::this_thread::get_id(), ctx.get(), ok };
+}
+
+} // namespace
+
+// Jobs running at the same time run on distinct workers, and each worker has
+// its own context, distinct from the submitting thread's.
+BOOST_AUTO_TEST_CASE(TestIslCtxPool_ThreadIsolation)
+{
+  const unsigned num_workers = 4;
+  IslCtxPool pool(num_workers, 1000);
+  BOOST_CHECK(pool.NumWorkers() == num_workers);
+
+  // Every job waits until all of them have started, so they must each hold a
+  // different worker.
+  std::atomic<unsigned> started(0);
+  std::vector<std::future<JobContext>> futures;
+  for (unsigned i = 0; i < num_workers; i++)
+  {
+    futures.push_back(pool.Submit([&started, num_workers]()
+    {
+      started++;
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (started < num_workers && std::chrono::steady_clock::now() < deadline)
+      {
+        std::this_thread::yield();
+      }
+      return UseCtx();
+    }));
+  }
+
+  std::set<std::thread::id> threads;
+  std::set<isl_ctx*> contexts;
+  for (auto& future : futures)
+  {
+    auto job = future.get();
+    BOOST_CHECK(job.result_ok);
+    threads.insert(job.thread);
+    contexts.insert(job.ctx);
+  }
+  BOOST_CHECK(threads.size() == num_workers);
+  BOOST_CHECK(contexts.size() == num_workers);
+  BOOST_CHECK(contexts.count(GetIslCtx().get()) == 0);
+  BOOST_CHECK(threads.count(std::this_thread::get_id()) == 0);
+}
+
+// Without a reset, a worker keeps reusing the same context across jobs.
+BOOST_AUTO_TEST_CASE(TestIslCtxPool_ReuseWithoutReset)
+{
+  IslCtxPool pool(2, 1000);
+
+  std::vector<std::future<JobContext>> futures;
+  for (unsigned i = 0; i < 64; i++)
+  {
+    futures.push_back(pool.Submit(UseCtx));
+  }
+
+  std::map<std::thread::id, isl_ctx*> ctx_of_thread;
+  for (auto& future : futures)
+  {
+    auto job = future.get();
+    BOOST_CHECK(job.result_ok);
+    auto it = ctx_of_thread.emplace(job.thread, job.ctx).first;
+    BOOST_CHECK(it->second == job.ctx);
+  }
+  BOOST_CHECK(ctx_of_thread.size() <= 2);
+}
+
+// With a reset after every job, later jobs still get a working context, and
+// a throwing job reports through its future without stopping the worker.
+BOOST_AUTO_TEST_CASE(TestIslCtxPool_ResetAndExceptions)
+{
+  IslCtxPool pool(1, 1);
+
+  auto failed = pool.Submit([]() -> int
+  {
+    UseCtx();
+    throw std::runtime_error("job failed");
+  });
+
+  std::vector<std::future<JobContext>> futures;
+  for (unsigned i = 0; i < 16; i++)
+  {
+    futures.push_back(pool.Submit(UseCtx));
+  }
+
+  BOOST_CHECK_THROW(failed.get(), std::runtime_error);
+  for (auto& future : futures)
+  {
+    BOOST_CHECK(future.get().result_ok);
+  }
+}
@@ -4,6 +4,7 @@
 
 #include "isl-wrapper/ctx-manager.hpp"
 #include "isl-wrapper/isl-functions.hpp"
+#include "isl-wrapper/piecewise-polynomial.hpp"
 
 BOOST_AUTO_TEST_CASE(TestIslFunctions_aff_from_qpolynomial)
 {
@@ -34,3 +35,50 @@ BOOST_AUTO_TEST_CASE(TestIslFunctions_aff_from_qpolynomial)
 
   BOOST_CHECK(result == nullptr);
 }
+
+BOOST_AUTO_TEST_CASE(TestIslFunctions_map_card)
+{
+  // Rectangular tile: counted in closed form.
+  auto p_map = isl_map_read_from_str(
+    GetIslCtx().get(),
+    "{ [t] -> [x, y] : 0 <= t < 4 and 4t <= x < 4t + 4 and 0 <= y < 3 }"
+  );
+  bool closed_form = false;
+  auto p_count = isl::map_card(isl_map_copy(p_map), &closed_form);
+  auto p_ref = isl_map_card(p_map);
+  BOOST_CHECK(closed_form);
+  BOOST_CHECK(isl_pw_qpolynomial_is_zero(
+    isl_pw_qpolynomial_sub(p_count, p_ref)
+  ) == isl_bool_true);
+
+  // Triangular: falls back to barvinok.
+  p_map = isl_map_read_from_str(
+    GetIslCtx().get(),
+    "{ [t] -> [x, y] : 0 <= t < 4 and 0 <= x < 4 and 0 <= y <= x }"
+  );
+  p_count = isl::map_card(isl_map_copy(p_map), &closed_form);
+  p_ref = isl_map_card(p_map);
+  BOOST_CHECK(!closed_form);
+  BOOST_CHECK(isl_pw_qpolynomial_is_zero(
+    isl_pw_qpolynomial_sub(p_count, p_ref)
+  ) == isl_bool_true);
+}
+
+BOOST_AUTO_TEST_CASE(TestIslFunctions_PiecewisePolynomial)
+{
+  auto p_pwqp = isl_pw_qpolynomial_read_from_str(
+    GetIslCtx().get(),
+    "[N] -> { [x] -> floor((x + 3)/4)*N + 2 : 0 <= x < N; [x] -> 1 : x >= N }"
+  );
+  isl::PiecewisePolynomial poly(p_pwqp);
+  isl_pw_qpolynomial_free(p_pwqp);
+
+  BOOST_CHECK(poly.NumParams() == 1);
+  BOOST_CHECK(poly.ParamNames().at(0) == "N");
+  BOOST_CHECK(poly.NumDims() == 1);
+
+  BOOST_CHECK(poly.Evaluate({10}, {0}) == 2);
+  BOOST_CHECK(poly.Evaluate({10}, {5}) == 22);
+  BOOST_CHECK(poly.Evaluate({10}, {12}) == 1);
+  BOOST_CHECK(poly.Evaluate({10}, {-1}) == 0);
+}
@@ -42,4 +42,48 @@ BOOST_AUTO_TEST_CASE(TestMappingToIsl)
       ));
     }
   }
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(TestMappingToIslSymbolicBounds)
+{
+  const auto CONV1D_CONFIG_PATH = TEST_CONFIG_PATH / "conv1d.yaml";
+  auto config = config::CompoundConfig({CONV1D_CONFIG_PATH.native()});
+  auto workload = problem::Workload();
+  problem::ParseWorkload(config.getRoot().lookup("problem"), workload);
+
+  const auto rank_P = workload.GetShape()->FlattenedDimensionNameToID.at("P");
+  const auto rank_R = workload.GetShape()->FlattenedDimensionNameToID.at("R");
+
+  auto loop_nest = loop::Nest();
+  loop_nest.AddLoop(rank_R, 0, 3, 1, spacetime::Dimension::SpaceX);
+  loop_nest.AddLoop(rank_P, 0, 5, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+  loop_nest.AddLoop(rank_P, 0, 4, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+
+  const auto symbolic_bounds = analysis::OutermostSymbolicBounds(loop_nest,
+                                                                 workload);
+  BOOST_CHECK(symbolic_bounds.size() == 1);
+  BOOST_CHECK(symbolic_bounds.at(2) == "P_2");
+  BOOST_CHECK(
+    analysis::SymbolicBoundValues(loop_nest, symbolic_bounds).at("P_2") == 4
+  );
+
+  const auto occupancies = analysis::OccupanciesFromMapping(loop_nest,
+                                                            workload,
+                                                            symbolic_bounds);
+
+  for (const auto& [buf, occ] : occupancies)
+  {
+    if (buf == analysis::LogicalBuffer(2, 2, 0))
+    {
+      BOOST_CHECK(occ.map.is_equal(
+        isl::map(
+          GetIslCtx().get(),
+          "[P_2] -> { [0, 0, P1, 0, 0, P0, R, 0] -> [5*P1 + P0] : "
+          "0 <= R < 3 and 0 <= P0 < 5 and 0 <= P1 < P_2 }"
+        )
+      ));
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "applications/model/model.hpp"
+#include "compound-config/compound-config.hpp"
+
+namespace
+{
+
+const auto TEST_CONFIG_PATH =
+  std::filesystem::absolute(__FILE__).parent_path() / "configs";
+
+std::vector<std::string> Lines(const std::string& text)
+{
+  std::vector<std::string> lines;
+  std::istringstream stream(text);
+  for (std::string line; std::getline(stream, line); )
+  {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+} // namespace
+
+// A mapping that fails to parse gets a failed row with its reason, and the
+// mappings around it are still evaluated.
+BOOST_AUTO_TEST_CASE(TestModelRunBatch_InvalidMapping)
+{
+  config::CompoundConfig config(std::vector<std::string>{ (TEST_CONFIG_PATH / "conv1x1.yaml").native(),
+                                                          (TEST_CONFIG_PATH / "batch.yaml").native() });
+  application::Model model(&config, std::filesystem::temp_directory_path().native());
+
+  auto mappings_node = config.getRoot().lookup("mappings");
+  std::vector<config::CompoundConfigNode> mappings;
+  for (int i = 0; i < mappings_node.getLength(); i++)
+  {
+    mappings.push_back(mappings_node[i]);
+  }
+
+  std::ostringstream out;
+  model.RunBatch(mappings, 2, out);
+
+  auto rows = Lines(out.str());
+  BOOST_REQUIRE(rows.size() == 4);
+  BOOST_CHECK(rows[1].rfind("0,ok,", 0) == 0);
+  BOOST_CHECK(rows[2].rfind("1,fail,,,,,", 0) == 0);
+  BOOST_CHECK(rows[2].find("product of all factors of dimension P") != std::string::npos);
+  BOOST_CHECK(rows[3].rfind("2,ok,", 0) == 0);
+
+  // The reason is a single CSV field.
+  for (auto& row : rows)
+  {
+    BOOST_CHECK(std::count(row.begin(), row.end(), ',') == 6);
+  }
+}
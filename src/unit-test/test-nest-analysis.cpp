@@ -0,0 +1,166 @@
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+
+#include "compound-config/compound-config.hpp"
+#include "loop-analysis/nest-analysis.hpp"
+#include "workload/workload.hpp"
+
+extern bool gEnableClosedFormAnalysis;
+
+namespace
+{
+
+const auto TEST_CONFIG_PATH =
+  std::filesystem::absolute(__FILE__).parent_path() / "configs";
+
+problem::Workload LoadWorkload(const std::string& file_name)
+{
+  auto config = config::CompoundConfig({(TEST_CONFIG_PATH / file_name).native()});
+  auto workload = problem::Workload();
+  problem::ParseWorkload(config.getRoot().lookup("problem"), workload);
+  return workload;
+}
+
+struct NestAnalysisResult
+{
+  analysis::CompoundDataMovementNest working_sets;
+  analysis::CompoundComputeNest compute_info;
+};
+
+NestAnalysisResult Analyze(problem::Workload& workload, const loop::Nest& nest,
+                           const std::map<unsigned, std::uint64_t>& fanoutX,
+                           const std::map<unsigned, std::uint64_t>& fanoutY)
+{
+  analysis::NestAnalysis analysis;
+  analysis.Init(&workload, &nest, fanoutX, fanoutY);
+  return { analysis.GetWorkingSets(), analysis.GetComputeInfo() };
+}
+
+void CheckSameResult(const NestAnalysisResult& expected, const NestAnalysisResult& actual)
+{
+  BOOST_REQUIRE(expected.compute_info.size() == actual.compute_info.size());
+  for (unsigned i = 0; i < expected.compute_info.size(); i++)
+  {
+    BOOST_CHECK(expected.compute_info[i].replication_factor == actual.compute_info[i].replication_factor);
+    BOOST_CHECK_CLOSE(expected.compute_info[i].accesses, actual.compute_info[i].accesses, 1e-9);
+  }
+  // Only the innermost entry carries the temporal iteration count.
+  BOOST_CHECK(expected.compute_info[0].max_temporal_iterations == actual.compute_info[0].max_temporal_iterations);
+
+  BOOST_REQUIRE(expected.working_sets.size() == actual.working_sets.size());
+  for (unsigned pv = 0; pv < expected.working_sets.size(); pv++)
+  {
+    BOOST_REQUIRE(expected.working_sets[pv].size() == actual.working_sets[pv].size());
+    for (unsigned i = 0; i < expected.working_sets[pv].size(); i++)
+    {
+      auto& x = expected.working_sets[pv][i];
+      auto& y = actual.working_sets[pv][i];
+      BOOST_CHECK(x.size == y.size);
+      BOOST_CHECK(x.replication_factor == y.replication_factor);
+      BOOST_CHECK(x.fanout == y.fanout);
+      BOOST_CHECK(x.is_on_storage_boundary == y.is_on_storage_boundary);
+      BOOST_CHECK(x.is_master_spatial == y.is_master_spatial);
+      BOOST_CHECK_CLOSE(x.link_transfers, y.link_transfers, 1e-9);
+
+      BOOST_REQUIRE(x.access_stats.stats.size() == y.access_stats.stats.size());
+      for (auto it = x.access_stats.stats.begin(), jt = y.access_stats.stats.begin();
+           it != x.access_stats.stats.end(); it++, jt++)
+      {
+        BOOST_CHECK(it->first == jt->first);
+        BOOST_CHECK_CLOSE(it->second.accesses, jt->second.accesses, 1e-9);
+        BOOST_CHECK_CLOSE(it->second.hops, jt->second.hops, 1e-9);
+        BOOST_CHECK_CLOSE(it->second.unicast_hops, jt->second.unicast_hops, 1e-9);
+      }
+    }
+  }
+}
+
+// The closed form must reproduce the walk exactly on nests it applies to.
+void CheckClosedForm(problem::Workload& workload, const loop::Nest& nest,
+                     const std::map<unsigned, std::uint64_t>& fanoutX,
+                     const std::map<unsigned, std::uint64_t>& fanoutY)
+{
+  bool saved = gEnableClosedFormAnalysis;
+
+  gEnableClosedFormAnalysis = false;
+  auto walked = Analyze(workload, nest, fanoutX, fanoutY);
+  gEnableClosedFormAnalysis = true;
+  auto closed_form = Analyze(workload, nest, fanoutX, fanoutY);
+
+  gEnableClosedFormAnalysis = saved;
+
+  CheckSameResult(walked, closed_form);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestClosedFormAnalysis_Gemm)
+{
+  auto workload = LoadWorkload("gemm.yaml");
+  auto shape = workload.GetShape();
+  const auto rank_M = shape->FlattenedDimensionNameToID.at("M");
+  const auto rank_N = shape->FlattenedDimensionNameToID.at("N");
+  const auto rank_K = shape->FlattenedDimensionNameToID.at("K");
+
+  auto loop_nest = loop::Nest(*shape);
+  loop_nest.AddLoop(rank_K, 0, 4, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+  loop_nest.AddLoop(rank_N, 0, 3, 1, spacetime::Dimension::SpaceX);
+  loop_nest.AddLoop(rank_M, 0, 4, 1, spacetime::Dimension::SpaceX);
+  loop_nest.AddLoop(rank_N, 0, 2, 1, spacetime::Dimension::Time);
+  loop_nest.AddLoop(rank_K, 0, 3, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+  loop_nest.AddLoop(rank_M, 0, 4, 1, spacetime::Dimension::Time);
+  loop_nest.AddLoop(rank_N, 0, 2, 1, spacetime::Dimension::Time);
+  loop_nest.AddLoop(rank_K, 0, 2, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+
+  CheckClosedForm(workload, loop_nest, { { 0, 1 }, { 1, 12 }, { 2, 1 } }, { { 0, 1 }, { 1, 1 }, { 2, 1 } });
+}
+
+BOOST_AUTO_TEST_CASE(TestClosedFormAnalysis_GemmSpatialReduction)
+{
+  auto workload = LoadWorkload("gemm.yaml");
+  auto shape = workload.GetShape();
+  const auto rank_M = shape->FlattenedDimensionNameToID.at("M");
+  const auto rank_N = shape->FlattenedDimensionNameToID.at("N");
+  const auto rank_K = shape->FlattenedDimensionNameToID.at("K");
+
+  // The innermost fanout feeds the compute units directly.
+  auto loop_nest = loop::Nest(*shape);
+  loop_nest.AddLoop(rank_K, 0, 4, 1, spacetime::Dimension::SpaceX);
+  loop_nest.AddLoop(rank_M, 0, 2, 1, spacetime::Dimension::SpaceX);
+  loop_nest.AddLoop(rank_N, 0, 3, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+  loop_nest.AddLoop(rank_K, 0, 6, 1, spacetime::Dimension::Time);
+  loop_nest.AddLoop(rank_M, 0, 8, 1, spacetime::Dimension::Time);
+  loop_nest.AddLoop(rank_N, 0, 4, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+
+  CheckClosedForm(workload, loop_nest, { { 0, 8 }, { 1, 1 } }, { { 0, 1 }, { 1, 1 } });
+}
+
+BOOST_AUTO_TEST_CASE(TestClosedFormAnalysis_Conv1x1)
+{
+  auto workload = LoadWorkload("conv1x1.yaml");
+  auto shape = workload.GetShape();
+  const auto rank_P = shape->FlattenedDimensionNameToID.at("P");
+  const auto rank_Q = shape->FlattenedDimensionNameToID.at("Q");
+  const auto rank_C = shape->FlattenedDimensionNameToID.at("C");
+  const auto rank_K = shape->FlattenedDimensionNameToID.at("K");
+
+  auto loop_nest = loop::Nest(*shape);
+  loop_nest.AddLoop(rank_C, 0, 4, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+  loop_nest.AddLoop(rank_K, 0, 4, 1, spacetime::Dimension::SpaceX);
+  loop_nest.AddLoop(rank_C, 0, 2, 1, spacetime::Dimension::SpaceY);
+  loop_nest.AddLoop(rank_P, 0, 8, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+  loop_nest.AddLoop(rank_Q, 0, 8, 1, spacetime::Dimension::Time);
+  loop_nest.AddLoop(rank_K, 0, 4, 1, spacetime::Dimension::Time);
+  loop_nest.AddLoop(rank_C, 0, 2, 1, spacetime::Dimension::Time);
+  loop_nest.AddStorageTilingBoundary();
+
+  CheckClosedForm(workload, loop_nest, { { 0, 1 }, { 1, 4 }, { 2, 1 } }, { { 0, 1 }, { 1, 2 }, { 2, 1 } });
+}
@@ -0,0 +1,208 @@
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <vector>
+
+#include "util/numeric.hpp"
+
+namespace
+{
+
+// The eager enumeration Factors used before it unranked sets lazily: split n
+// recursively, trying factors in CalculateAllFactors_() order, then insert
+// the given factors and drop the sets outside the min/max bounds. Mapspace
+// indices depend on this order, so the lazy version must reproduce it.
+std::vector<unsigned long> AllFactors(unsigned long n)
+{
+  std::vector<unsigned long> factors;
+  for (unsigned long i = 1; i * i <= n; i++)
+  {
+    if (n % i == 0)
+    {
+      factors.push_back(i);
+      if (i * i != n)
+      {
+        factors.push_back(n / i);
+      }
+    }
+  }
+  return factors;
+}
+
+std::vector<std::vector<unsigned long>> SplitRecursive(unsigned long n, int order,
+                                                       const std::vector<unsigned long>& all_factors)
+{
+  if (order == 0)
+  {
+    return {{}};
+  }
+  if (order == 1)
+  {
+    return {{n}};
+  }
+  std::vector<std::vector<unsigned long>> retval;
+  for (auto factor : all_factors)
+  {
+    if (n % factor == 0)
+    {
+      auto subproblem = SplitRecursive(n / factor, order - 1, all_factors);
+      for (auto& cofactors : subproblem)
+      {
+        cofactors.push_back(factor);
+      }
+      retval.insert(retval.end(), subproblem.begin(), subproblem.end());
+    }
+  }
+  return retval;
+}
+
+std::vector<std::vector<unsigned long>> EagerFactors(unsigned long n, int order,
+                                                     const std::map<unsigned, unsigned long>& given,
+                                                     const std::map<unsigned, unsigned long>& max,
+                                                     const std::map<unsigned, unsigned long>& min)
+{
+  unsigned long remaining = n;
+  for (auto& given_factor : given)
+  {
+    remaining /= given_factor.second;
+  }
+
+  auto cofactor_sets = SplitRecursive(remaining, order - given.size(), AllFactors(remaining));
+  for (auto& cofactors : cofactor_sets)
+  {
+    for (auto& given_factor : given)
+    {
+      cofactors.insert(cofactors.begin() + given_factor.first, given_factor.second);
+    }
+  }
+
+  std::vector<std::vector<unsigned long>> retval;
+  for (auto& cofactors : cofactor_sets)
+  {
+    bool legal = true;
+    for (auto& bound : max)
+    {
+      legal &= cofactors.at(bound.first) <= bound.second;
+    }
+    for (auto& bound : min)
+    {
+      legal &= cofactors.at(bound.first) >= bound.second;
+    }
+    if (legal)
+    {
+      retval.push_back(cofactors);
+    }
+  }
+  return retval;
+}
+
+void CheckUnranking(unsigned long n, int order,
+                    std::map<unsigned, unsigned long> given = {},
+                    std::map<unsigned, unsigned long> max = {},
+                    std::map<unsigned, unsigned long> min = {})
+{
+  Factors factors(n, order, given);
+  if (!max.empty())
+  {
+    factors.PruneMax(max);
+  }
+  if (!min.empty())
+  {
+    factors.PruneMin(min);
+  }
+
+  auto expected = EagerFactors(n, order, given, max, min);
+  BOOST_REQUIRE_MESSAGE(factors.size() == expected.size(),
+                        "n=" << n << " order=" << order << ": " << factors.size()
+                        << " sets, expected " << expected.size());
+  for (std::uint64_t index = 0; index < expected.size(); index++)
+  {
+    BOOST_CHECK(factors[index] == expected[index]);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestFactors_UnrankingMatchesRecursiveOrder)
+{
+  for (unsigned long n : { 1UL, 2UL, 12UL, 36UL, 64UL, 210UL, 720UL })
+  {
+    for (int order = 1; order <= 4; order++)
+    {
+      CheckUnranking(n, order);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestFactors_UnrankingWithGivenFactors)
+{
+  CheckUnranking(720, 3, { { 0, 4 } });
+  CheckUnranking(720, 4, { { 1, 3 } });
+  CheckUnranking(720, 4, { { 0, 2 }, { 3, 5 } });
+  CheckUnranking(64, 3, { { 2, 64 } });
+  CheckUnranking(36, 2, { { 0, 6 }, { 1, 6 } });
+}
+
+BOOST_AUTO_TEST_CASE(TestFactors_UnrankingWithBounds)
+{
+  CheckUnranking(720, 3, {}, { { 0, 8 } });
+  CheckUnranking(720, 4, {}, { { 1, 6 }, { 3, 10 } }, { { 2, 3 } });
+  CheckUnranking(720, 4, { { 0, 2 } }, { { 2, 12 } }, { { 1, 4 } });
+  CheckUnranking(210, 3, {}, {}, { { 0, 2 }, { 1, 2 }, { 2, 2 } });
+  // Bounds that exclude everything.
+  CheckUnranking(64, 2, {}, { { 0, 2 }, { 1, 2 } });
+}
+
+// Every pass of the keyed permutation must visit each index in [0, bound)
+// exactly once, including bounds just above and below the Feistel domain's
+// powers of two.
+BOOST_AUTO_TEST_CASE(TestPermutationGenerator128_Bijection)
+{
+  std::vector<uint128_t> bounds;
+  for (unsigned bound = 1; bound <= 130; bound++)
+  {
+    bounds.push_back(bound);
+  }
+  bounds.push_back(1023);
+  bounds.push_back(1025);
+  bounds.push_back(65536);
+
+  for (auto bound : bounds)
+  {
+    for (std::uint64_t key : { 0ULL, 1ULL, 0x9e3779b97f4a7c15ULL })
+    {
+      PermutationGenerator128 permutation(bound, key);
+      std::vector<bool> seen(std::size_t(bound), false);
+      std::vector<uint128_t> order;
+      for (uint128_t i = 0; i < bound; i++)
+      {
+        BOOST_CHECK(!permutation.Exhausted());
+        auto value = permutation.Next();
+        BOOST_REQUIRE(value < bound);
+        BOOST_CHECK(value == permutation.At(i));
+        BOOST_CHECK(!seen[std::size_t(value)]);
+        seen[std::size_t(value)] = true;
+        order.push_back(value);
+      }
+      BOOST_CHECK(permutation.Exhausted());
+
+      // The next pass repeats the same order.
+      for (auto value : order)
+      {
+        BOOST_CHECK(permutation.Next() == value);
+      }
+    }
+  }
+}
+
+// Different keys give different orders, so threads don't search in lockstep.
+BOOST_AUTO_TEST_CASE(TestPermutationGenerator128_Keys)
+{
+  PermutationGenerator128 a(1000, 1), b(1000, 2);
+  unsigned same = 0;
+  for (uint128_t i = 0; i < 1000; i++)
+  {
+    same += (a.At(i) == b.At(i));
+  }
+  BOOST_CHECK(same < 50);
+}
@@ -0,0 +1,102 @@
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+#include "loop-analysis/point-set.hpp"
+
+namespace
+{
+
+std::vector<Coordinate> Corners(const MultiAAHR& s)
+{
+  std::vector<Coordinate> corners;
+  if (s.numAAHRs() != 0)
+  {
+    for (auto& aahr : s.GetAAHRs())
+    {
+      aahr.AppendCorners(corners);
+    }
+  }
+  return corners;
+}
+
+std::vector<Coordinate> Corners(const HybridAAHR& s)
+{
+  std::vector<Coordinate> corners;
+  if (s.numAAHRs() != 0)
+  {
+    for (auto& aahr : s.GetAAHRs())
+    {
+      aahr.AppendCorners(corners);
+    }
+  }
+  return corners;
+}
+
+} // namespace
+
+// HybridAAHR must build exactly the AAHR lists MultiAAHR does, in the same
+// order, whether a set is held inline or promoted.
+BOOST_AUTO_TEST_CASE(TestHybridAAHRMatchesMultiAAHR)
+{
+  std::mt19937 rng(42);
+  auto RandomPoint = [&](unsigned order)
+  {
+    Point p(order);
+    for (unsigned rank = 0; rank < order; rank++)
+    {
+      p[rank] = rng() % 6;
+    }
+    return p;
+  };
+
+  for (int trial = 0; trial < 2000; trial++)
+  {
+    unsigned order = 1 + rng() % 3;
+    MultiAAHR multi_a(order), multi_b(order);
+    HybridAAHR hybrid_a(order), hybrid_b(order);
+
+    for (int step = 0; step < 8; step++)
+    {
+      auto p = RandomPoint(order);
+      auto q = RandomPoint(order);
+      Point min(order), max(order);
+      for (unsigned rank = 0; rank < order; rank++)
+      {
+        min[rank] = std::min(p[rank], q[rank]);
+        max[rank] = std::max(p[rank], q[rank]) + 1;
+      }
+
+      switch (rng() % 5)
+      {
+        case 0:
+          multi_a.Subtract(MultiAAHR(order, min, max));
+          hybrid_a.Subtract(HybridAAHR(order, min, max));
+          break;
+        case 1:
+          multi_a += p;
+          hybrid_a += p;
+          break;
+        case 2:
+          multi_a += MultiAAHR(order, min, max);
+          hybrid_a += HybridAAHR(order, min, max);
+          break;
+        case 3:
+          multi_b = multi_a - MultiAAHR(order, min, max);
+          hybrid_b = hybrid_a - HybridAAHR(order, min, max);
+          break;
+        default:
+          multi_b += multi_a;
+          hybrid_b += hybrid_a;
+          break;
+      }
+
+      BOOST_REQUIRE(Corners(multi_a) == Corners(hybrid_a));
+      BOOST_REQUIRE(Corners(multi_b) == Corners(hybrid_b));
+      BOOST_REQUIRE_EQUAL(multi_a.size(), hybrid_a.size());
+      BOOST_REQUIRE_EQUAL(multi_a.empty(), hybrid_a.empty());
+      BOOST_REQUIRE_EQUAL(multi_a == multi_b, hybrid_a == hybrid_b);
+      BOOST_REQUIRE(multi_a.GetTranslation(multi_b) == hybrid_a.GetTranslation(hybrid_b));
+    }
+  }
+}
@@ -0,0 +1,186 @@
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "compound-config/compound-config.hpp"
+#include "workload/shape-models/operation-space.hpp"
+#include "workload/workload.hpp"
+
+namespace
+{
+
+// Between them, the two shapes cover every unrolled (rank, terms per rank)
+// kernel and two combinations that take the run-time fallback. Terms without
+// a coefficient mix with ones that have one, so the padding and the implicit
+// unit coefficient are both exercised.
+
+// Kernels (4, 2), (4, 1) and (3, 1).
+const std::string RANK_3_4_SHAPE = R"(
+shape:
+  name: Rank3And4
+  dimensions: [ A, B, C, D, E, F ]
+  coefficients:
+  - { name: c0, default: 1 }
+  - { name: c1, default: 1 }
+  - { name: c2, default: 1 }
+  - { name: c3, default: 1 }
+  data_spaces:
+  - name: Rank4Terms2
+    projection:
+    - [ [A] ]
+    - [ [B, c0] ]
+    - [ [C], [E, c1] ]
+    - [ [D, c2], [F, c3] ]
+  - name: Rank4Terms1
+    projection:
+    - [ [F] ]
+    - [ [E, c3] ]
+    - [ [B] ]
+    - [ [A, c1] ]
+  - name: Rank3Terms1
+    projection:
+    - [ [C, c2] ]
+    - [ [D] ]
+    - [ [A] ]
+    read_write: True
+)";
+
+// Kernels (2, 1) and (1, 1); (2, 3) and (5, 1) use the fallback.
+const std::string RANK_1_2_FALLBACK_SHAPE = R"(
+shape:
+  name: Rank1And2AndFallback
+  dimensions: [ A, B, C, D, E, F ]
+  coefficients:
+  - { name: c0, default: 1 }
+  - { name: c1, default: 1 }
+  - { name: c2, default: 1 }
+  - { name: c3, default: 1 }
+  data_spaces:
+  - name: Rank2Terms1
+    projection:
+    - [ [A, c0] ]
+    - [ [F] ]
+  - name: Rank1Terms1
+    projection:
+    - [ [D, c1] ]
+  - name: Rank2Terms3
+    projection:
+    - [ [A, c0], [B], [C, c2] ]
+    - [ [D, c3], [E, c1] ]
+  - name: Rank5Terms1
+    projection:
+    - [ [F, c0] ]
+    - [ [E] ]
+    - [ [D, c1] ]
+    - [ [C] ]
+    - [ [B, c3] ]
+    read_write: True
+)";
+
+// Exposes the interpreter path: without compiled kernels, OperationSpace
+// walks the shape's projection expressions.
+class TestWorkload : public problem::Workload
+{
+ public:
+  void DropProjectionKernels()
+  {
+    projection_kernels_.clear();
+  }
+};
+
+// Corners of every data space projected from an AAHR and from a point.
+std::vector<std::vector<Coordinate>> Project(TestWorkload& workload,
+                                                      const problem::OperationPoint& low,
+                                                      const problem::OperationPoint& high)
+{
+  problem::OperationSpace aahr(&workload, low, high);
+  problem::OperationSpace point(&workload);
+  point += low;
+
+  std::vector<std::vector<Coordinate>> corners;
+  for (unsigned d = 0; d < workload.GetShape()->NumDataSpaces; d++)
+  {
+    corners.emplace_back();
+    aahr.AppendCorners(d, corners.back());
+    corners.emplace_back();
+    point.AppendCorners(d, corners.back());
+  }
+  return corners;
+}
+
+void CheckKernelsMatchInterpreter(const std::string& shape_yaml, unsigned seed)
+{
+  config::CompoundConfig config(shape_yaml, "yaml");
+  TestWorkload workload;
+  workload.ParseShape(config.getRoot().lookup("shape"));
+
+  auto shape = workload.GetShape();
+  problem::Workload::FactorizedBounds bounds;
+  for (unsigned dim = 0; dim < shape->NumFactorizedDimensions; dim++)
+  {
+    bounds[dim] = 1 << 20;
+  }
+  workload.SetFactorizedBounds(bounds);
+
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> coefficient_dist(-3, 3);
+  std::uniform_int_distribution<int> coordinate_dist(0, 15);
+  std::uniform_int_distribution<int> extent_dist(0, 7);
+
+  for (unsigned trial = 0; trial < 20; trial++)
+  {
+    // Random coefficients, including negative ones that flip the corners.
+    problem::Workload::Coefficients coefficients;
+    for (unsigned i = 0; i < shape->NumCoefficients; i++)
+    {
+      coefficients[i] = coefficient_dist(rng);
+    }
+    workload.SetCoefficients(coefficients);
+    for (unsigned d = 0; d < shape->NumDataSpaces; d++)
+    {
+      BOOST_REQUIRE(workload.GetProjectionKernel(d) != nullptr);
+      BOOST_CHECK(workload.GetProjectionKernel(d)->Rank() == shape->DataSpaceOrder.at(d));
+    }
+
+    std::vector<std::pair<problem::OperationPoint, problem::OperationPoint>> aahrs;
+    for (unsigned i = 0; i < 50; i++)
+    {
+      problem::OperationPoint low, high;
+      for (unsigned dim = 0; dim < shape->NumFlattenedDimensions; dim++)
+      {
+        low[dim] = coordinate_dist(rng);
+        high[dim] = low[dim] + extent_dist(rng);
+      }
+      aahrs.emplace_back(low, high);
+    }
+
+    std::vector<std::vector<std::vector<Coordinate>>> compiled;
+    for (auto& aahr : aahrs)
+    {
+      compiled.push_back(Project(workload, aahr.first, aahr.second));
+    }
+
+    workload.DropProjectionKernels();
+    BOOST_REQUIRE(workload.GetProjectionKernel(0) == nullptr);
+
+    for (unsigned i = 0; i < aahrs.size(); i++)
+    {
+      auto interpreted = Project(workload, aahrs[i].first, aahrs[i].second);
+      BOOST_CHECK(compiled[i] == interpreted);
+    }
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestProjectionKernel_Rank3And4)
+{
+  CheckKernelsMatchInterpreter(RANK_3_4_SHAPE, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestProjectionKernel_Rank1And2AndFallback)
+{
+  CheckKernelsMatchInterpreter(RANK_1_2_FALLBACK_SHAPE, 2);
+}
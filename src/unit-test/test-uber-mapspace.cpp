@@ -0,0 +1,214 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "compound-config/compound-config.hpp"
+#include "mapspaces/mapspace-factory.hpp"
+#include "model/engine.hpp"
+#include "model/sparse-optimization-parser.hpp"
+#include "search/linear-pruned.hpp"
+#include "workload/workload.hpp"
+
+namespace
+{
+
+const auto TEST_CONFIG_PATH =
+  std::filesystem::absolute(__FILE__).parent_path() / "configs";
+
+// Builds an Uber mapspace from the given test configs, which hold the
+// architecture, the mapspace constraints and the problem.
+struct MapSpaceFixture
+{
+  config::CompoundConfig config;
+  problem::Workload workload;
+  model::Engine::Specs arch_specs;
+  sparse::SparseOptimizationInfo sparse_optimizations;
+  mapspace::MapSpace* mapspace = nullptr;
+
+  MapSpaceFixture(const std::vector<std::string>& file_names, bool permutation_classes = false) :
+      config(ConfigPaths(file_names))
+  {
+    auto root = config.getRoot();
+    problem::ParseWorkload(root.lookup("problem"), workload);
+    arch_specs = model::Engine::ParseSpecs(root.lookup("arch"), false);
+    sparse_optimizations = sparse::ParseAndConstruct(config::CompoundConfigNode(), arch_specs);
+
+    config::CompoundConfigNode arch_constraints;
+    auto unsplit = mapspace::ParseAndConstruct(root.lookup("mapspace"), arch_constraints, arch_specs,
+                                               workload, true, permutation_classes);
+    mapspace = unsplit->Split(1).at(0);
+  }
+
+  static std::vector<std::string> ConfigPaths(const std::vector<std::string>& file_names)
+  {
+    std::vector<std::string> paths;
+    for (auto& file_name : file_names)
+    {
+      paths.push_back((TEST_CONFIG_PATH / file_name).native());
+    }
+    return paths;
+  }
+
+  // Evaluates one mapping, reporting failures the way a mapper thread does.
+  search::Status Evaluate(mapspace::ID mapping_id, model::Engine& engine)
+  {
+    Mapping mapping;
+    auto construction_status = mapspace->ConstructMapping(mapping_id, &mapping);
+    for (auto& status : construction_status)
+    {
+      if (!status.success)
+        return search::Status::MappingConstructionFailure;
+    }
+
+    auto eval_status = engine.Evaluate(mapping, workload, &sparse_optimizations);
+    for (auto& status : eval_status)
+    {
+      if (!status.success)
+        return search::Status::EvalFailure;
+    }
+    return search::Status::Success;
+  }
+};
+
+} // namespace
+
+// The analytic bound of an index factorization must not exceed the modeled
+// cost of any mapping with that factorization, or pruning could discard the
+// optimum. The mapspace (a GEMM on three levels with a spatial fanout) is
+// constrained just enough that every mapping of a factorization can be
+// evaluated.
+BOOST_AUTO_TEST_CASE(TestUberMapSpace_IndexFactorizationBoundIsSound)
+{
+  MapSpaceFixture fixture({ "mapspace.yaml", "gemm.yaml" });
+  auto mapspace = fixture.mapspace;
+  auto sizes = mapspace->AllSizes();
+  auto num_index_factorizations = std::uint64_t(mapspace->Size(mapspace::Dimension::IndexFactorization));
+
+  std::mt19937_64 rng(1);
+  std::uniform_int_distribution<std::uint64_t> index_factorization_dist(0, num_index_factorizations - 1);
+
+  model::Engine engine;
+  engine.Spec(fixture.arch_specs);
+  unsigned num_evaluated = 0;
+  for (unsigned sample = 0; sample < 8; sample++)
+  {
+    uint128_t index_factorization_id = index_factorization_dist(rng);
+    auto bound = mapspace->IndexFactorizationBound(index_factorization_id);
+
+    mapspace::ID mapping_id(sizes);
+    mapping_id.Set(int(mapspace::Dimension::IndexFactorization), index_factorization_id);
+    for (uint128_t permutation = 0; permutation < sizes[int(mapspace::Dimension::LoopPermutation)]; permutation++)
+    {
+      mapping_id.Set(int(mapspace::Dimension::LoopPermutation), permutation);
+      for (uint128_t spatial = 0; spatial < sizes[int(mapspace::Dimension::Spatial)]; spatial++)
+      {
+        mapping_id.Set(int(mapspace::Dimension::Spatial), spatial);
+        for (uint128_t bypass = 0; bypass < sizes[int(mapspace::Dimension::DatatypeBypass)]; bypass++)
+        {
+          mapping_id.Set(int(mapspace::Dimension::DatatypeBypass), bypass);
+          if (fixture.Evaluate(mapping_id, engine) != search::Status::Success)
+            continue;
+
+          num_evaluated++;
+          BOOST_CHECK_LE(bound.energy, engine.Energy() * (1 + 1e-9));
+          BOOST_CHECK_LE(bound.cycles, double(engine.Cycles()));
+        }
+      }
+    }
+  }
+
+  BOOST_CHECK(num_evaluated > 0);
+}
+
+namespace
+{
+
+struct Cost
+{
+  double energy = std::numeric_limits<double>::max();
+  double cycles = std::numeric_limits<double>::max();
+  double edp = std::numeric_limits<double>::max();
+
+  void Update(double mapping_energy, double mapping_cycles)
+  {
+    energy = std::min(energy, mapping_energy);
+    cycles = std::min(cycles, mapping_cycles);
+    edp = std::min(edp, mapping_energy * mapping_cycles);
+  }
+};
+
+struct SearchResult
+{
+  unsigned num_evaluated = 0;
+  Cost best;
+  // Best cost of each index factorization with a valid mapping.
+  std::map<std::uint64_t, Cost> best_per_index_factorization;
+};
+
+// Walks the whole pruned mapspace, as the linear_pruned search algorithm
+// does, and keeps the best of each metric.
+SearchResult ExhaustiveSearch(MapSpaceFixture& fixture)
+{
+  SearchResult result;
+  model::Engine engine;
+  engine.Spec(fixture.arch_specs);
+
+  search::LinearPrunedSearch search(config::CompoundConfigNode(), fixture.mapspace, 0);
+  mapspace::ID mapping_id;
+  while (search.Next(mapping_id))
+  {
+    auto status = fixture.Evaluate(mapping_id, engine);
+    if (status != search::Status::Success)
+    {
+      search.Report(status);
+      continue;
+    }
+
+    auto index_factorization_id = std::uint64_t(mapping_id[int(mapspace::Dimension::IndexFactorization)]);
+    result.num_evaluated++;
+    result.best.Update(engine.Energy(), engine.Cycles());
+    result.best_per_index_factorization[index_factorization_id].Update(engine.Energy(), engine.Cycles());
+    search.Report(status, engine.Energy());
+  }
+  return result;
+}
+
+void CheckSameCost(const Cost& expected, const Cost& actual)
+{
+  BOOST_CHECK_CLOSE(expected.energy, actual.energy, 1e-9);
+  BOOST_CHECK_CLOSE(expected.cycles, actual.cycles, 1e-9);
+  BOOST_CHECK_CLOSE(expected.edp, actual.edp, 1e-9);
+}
+
+} // namespace
+
+// Enumerating one loop permutation per reuse-equivalence class must not
+// change what an exhaustive search finds.
+BOOST_AUTO_TEST_CASE(TestUberMapSpace_PermutationClassesKeepBestCost)
+{
+  MapSpaceFixture expanded({ "exhaustive.yaml" }, false);
+  auto expanded_result = ExhaustiveSearch(expanded);
+
+  MapSpaceFixture classes({ "exhaustive.yaml" }, true);
+  auto classes_result = ExhaustiveSearch(classes);
+
+  BOOST_REQUIRE(classes_result.num_evaluated > 0);
+  BOOST_CHECK(classes_result.num_evaluated < expanded_result.num_evaluated);
+  CheckSameCost(expanded_result.best, classes_result.best);
+
+  // The same holds within each index factorization, which is what the
+  // pruned searches compare mappings by.
+  BOOST_REQUIRE(expanded_result.best_per_index_factorization.size() ==
+                classes_result.best_per_index_factorization.size());
+  for (auto& [index_factorization_id, expected] : expanded_result.best_per_index_factorization)
+  {
+    BOOST_REQUIRE(classes_result.best_per_index_factorization.count(index_factorization_id));
+    CheckSameCost(expected, classes_result.best_per_index_factorization.at(index_factorization_id));
+  }
+}
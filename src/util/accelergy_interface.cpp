@@ -25,20 +25,131 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 #include <stdexcept>
+#include <unistd.h>
 
 #include "util/accelergy_interface.hpp"
+#include "compound-config/compound-config.hpp"
 
 namespace accelergy
 {
 
+namespace
+{
+
+// Top-level input sections that Accelergy does not read.
+const std::vector<std::string> kNonHardwareSections = {
+  "problem", "mapping", "mappings", "mapper", "mapspace", "mapspace_constraints",
+  "arch_constraints", "architecture_constraints", "model", "sparse_optimizations",
+  "ERT", "ART"
+};
+
+// Serializes a YAML tree with map keys sorted, so that inputs differing only
+// in key order or formatting produce the same text.
+void CanonicalYAML(const YAML::Node& node, std::ostream& out)
+{
+  switch (node.Type())
+  {
+    case YAML::NodeType::Scalar:
+      out << node.Scalar().size() << ":" << node.Scalar();
+      break;
+    case YAML::NodeType::Sequence:
+      out << "[";
+      for (const auto& child : node)
+      {
+        CanonicalYAML(child, out);
+        out << ",";
+      }
+      out << "]";
+      break;
+    case YAML::NodeType::Map:
+    {
+      std::vector<std::pair<std::string, YAML::Node>> entries;
+      for (const auto& child : node)
+      {
+        entries.emplace_back(child.first.as<std::string>(), child.second);
+      }
+      std::sort(entries.begin(), entries.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+      out << "{";
+      for (const auto& entry : entries)
+      {
+        out << entry.first.size() << ":" << entry.first << "=";
+        CanonicalYAML(entry.second, out);
+        out << ",";
+      }
+      out << "}";
+      break;
+    }
+    default:
+      out << "~";
+      break;
+  }
+}
+
+// FNV-1a; the key names files on disk, so it must not change across builds
+// the way std::hash may.
+std::uint64_t StableHash(const std::string& text)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : text)
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+#ifdef USE_ACCELERGY
+std::string accelergyPath()
+{
+  std::string accelergy_path = exec("which accelergy");
+  // if `which` does not find it, we will try env
+  if (accelergy_path.find("accelergy") == std::string::npos)
+  {
+    accelergy_path = exec("echo $ACCELERGYPATH");
+    accelergy_path += "accelergy";
+  }
+  return accelergy_path.substr(0, accelergy_path.size() - 1);
+}
+
+// Publishes a file into the cache. Writers never hold locks: each one copies
+// to a private temporary name and renames it into place, which is atomic, so
+// readers see either no entry or a complete one. Concurrent writers of the
+// same key produce identical tables, so whichever rename lands last is fine.
+void PublishToCache(const std::filesystem::path& source, const std::filesystem::path& target)
+{
+  std::error_code ec;
+  auto temp = target;
+  temp += "." + std::to_string(getpid()) + ".tmp";
+  std::filesystem::copy_file(source, temp, std::filesystem::copy_options::overwrite_existing, ec);
+  if (!ec)
+  {
+    std::filesystem::rename(temp, target, ec);
+  }
+  if (ec)
+  {
+    std::filesystem::remove(temp, ec);
+    std::cerr << "WARNING: could not add " << source << " to the Accelergy cache." << std::endl;
+  }
+}
+#endif
+
+} // namespace
+
 std::string exec(const char* cmd)
 {
   std::string result = "";
   char buffer[128];
-  FILE* pipe = popen("which accelergy", "r");
+  FILE* pipe = popen(cmd, "r");
   if (!pipe)
   {
     std::cout << "popen(" << cmd << ") failed" << std::endl;
@@ -60,18 +171,79 @@ std::string exec(const char* cmd)
   return result;
 }
 
-void invokeAccelergy(std::vector<std::string> input_files, std::string out_prefix, std::string out_dir)
+std::string cacheKey(config::CompoundConfig* config)
 {
+  if (config->hasLConfig())
+  {
+    return "";
+  }
+
+  // Sections are keyed in name order, like map keys.
+  std::vector<std::pair<std::string, std::string>> sections;
+  for (const auto& section : config->getYConfig())
+  {
+    auto name = section.first.as<std::string>();
+    if (std::find(kNonHardwareSections.begin(), kNonHardwareSections.end(), name) ==
+        kNonHardwareSections.end())
+    {
+      std::ostringstream canonical;
+      CanonicalYAML(section.second, canonical);
+      sections.emplace_back(name, canonical.str());
+    }
+  }
+  std::sort(sections.begin(), sections.end());
+
+  std::string key_text;
+  for (const auto& section : sections)
+  {
+    key_text += section.first + "=" + section.second + ";";
+  }
 #ifdef USE_ACCELERGY
-  std::string accelergy_path = exec("which accelergy");
-  // if `which` does not find it, we will try env
-  if (accelergy_path.find("accelergy") == std::string::npos)
+  // Different Accelergy installations or plug-ins can produce different
+  // tables for the same architecture.
+  auto path = accelergyPath();
+  key_text += path + ";" + exec((path + " --version 2>&1").c_str());
+#endif
+
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << StableHash(key_text);
+  return key.str();
+}
+
+void invokeAccelergy(std::vector<std::string> input_files, std::string out_prefix, std::string out_dir,
+                     config::CompoundConfig* config)
+{
+#ifdef USE_ACCELERGY
+  namespace fs = std::filesystem;
+
+  fs::path ert_path = out_dir + "/" + out_prefix + ".ERT.yaml";
+  fs::path art_path = out_dir + "/" + out_prefix + ".ART.yaml";
+
+  // Keying queries the Accelergy installation, so it is skipped unless the
+  // cache is enabled.
+  const char* cache_root = getenv("TIMELOOP_ACCELERGY_CACHE");
+  std::string cache_key = (cache_root && *cache_root && config) ? cacheKey(config) : "";
+  bool use_cache = !cache_key.empty();
+  fs::path cache_dir = use_cache ? fs::path(cache_root) / cache_key : fs::path();
+
+  // An entry without an ART would leave a stale ART from an earlier run in
+  // place, so it counts as a miss.
+  if (use_cache && fs::exists(cache_dir / "ERT.yaml") && fs::exists(cache_dir / "ART.yaml"))
   {
-    accelergy_path = exec("echo $ACCELERGYPATH");
-    accelergy_path += "accelergy";
+    std::error_code ec;
+    fs::copy_file(cache_dir / "ERT.yaml", ert_path, fs::copy_options::overwrite_existing, ec);
+    if (!ec)
+    {
+      fs::copy_file(cache_dir / "ART.yaml", art_path, fs::copy_options::overwrite_existing, ec);
+    }
+    if (!ec)
+    {
+      std::cout << "Using cached Accelergy tables from " << cache_dir.string() << std::endl;
+      return;
+    }
   }
-  //std::cout << "Invoke Accelergy at: " << accelergy_path << std::endl;
-  std::string cmd = accelergy_path.substr(0, accelergy_path.size() - 1);
+
+  std::string cmd = accelergyPath();
   for (auto input_file : input_files)
   {
     cmd += " " + input_file;
@@ -85,10 +257,23 @@ void invokeAccelergy(std::vector<std::string> input_files, std::string out_prefi
     std::cout << "Failed to run Accelergy. Did you install Accelergy or specify ACCELERGYPATH correctly? Or check accelergy.log to see what went wrong" << std::endl;
     exit(0);
   }
+
+  if (use_cache)
+  {
+    std::error_code ec;
+    fs::create_directories(cache_dir, ec);
+    // The ERT marks an entry as present, so it is published last.
+    if (fs::exists(art_path))
+    {
+      PublishToCache(art_path, cache_dir / "ART.yaml");
+    }
+    PublishToCache(ert_path, cache_dir / "ERT.yaml");
+  }
 #else
   (void) input_files;
   (void) out_prefix;
   (void) out_dir;
+  (void) config;
 #endif
   return;
 }
@@ -25,6 +25,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "util/numeric.hpp"
@@ -74,111 +75,121 @@ void Factors::CalculateAllFactors_(unsigned long of)
   }
 }
 
-// Return a vector of all order-way cofactor sets of n.
-std::vector<std::vector<unsigned long>>
-Factors::MultiplicativeSplitRecursive_(unsigned long n, int order)
+void Factors::Init_(const unsigned long remaining, const int order)
 {
-  if (order == 0)
+  remaining_ = remaining;
+  order_ = order;
+
+  free_positions_.clear();
+  for (unsigned pos = 0; pos < unsigned(order); pos++)
   {
-    if (n != 1)
+    if (given_.find(pos) == given_.end())
     {
-      std::cerr << "ERROR: Factors: cannot split n=" << n << " into 0 cofactors." << std::endl;
-      assert(false);
+      free_positions_.push_back(pos);
     }
-    return {{}};
   }
-  else if (order == 1)
+
+  if (free_positions_.empty() && remaining != 1)
   {
-    return {{n}};
+    std::cerr << "ERROR: Factors: cannot split n=" << remaining << " into 0 cofactors." << std::endl;
+    assert(false);
   }
-  else
+
+  CalculateAllFactors_(remaining);
+  sorted_factors_ = all_factors_;
+  std::sort(sorted_factors_.begin(), sorted_factors_.end());
+
+  CountSplits_();
+}
+
+bool Factors::InBounds_(unsigned position, unsigned long factor) const
+{
+  auto max_it = max_.find(position);
+  if (max_it != max_.end() && factor > max_it->second)
   {
-    std::vector<std::vector<unsigned long>> retval;
-    for (auto factor = all_factors_.begin(); factor != all_factors_.end(); factor++)
+    return false;
+  }
+  auto min_it = min_.find(position);
+  if (min_it != min_.end() && factor < min_it->second)
+  {
+    return false;
+  }
+  return true;
+}
+
+std::size_t Factors::FactorIndex_(unsigned long factor) const
+{
+  return std::lower_bound(sorted_factors_.begin(), sorted_factors_.end(), factor)
+    - sorted_factors_.begin();
+}
+
+// Counting is a DP over the divisors of remaining_, so it takes
+// O(order * divisors^2) time and O(order * divisors) space no matter how
+// many cofactor sets there are.
+void Factors::CountSplits_()
+{
+  size_ = 0;
+  num_splits_.clear();
+
+  for (auto& given_factor : given_)
+  {
+    if (!InBounds_(given_factor.first, given_factor.second))
     {
-      // This factor is only acceptable if the residue is divisible by it.
-      if (n % (*factor) == 0)
-      {
-        // Recursive call.
-        std::vector<std::vector<unsigned long>> subproblem =
-          MultiplicativeSplitRecursive_(n / (*factor), order - 1);
+      return;
+    }
+  }
 
-        // Append this factor to the end of each vector returned by the
-        // recursive call.
-        for (auto vector = subproblem.begin(); vector != subproblem.end(); vector++)
-        {
-          vector->push_back(*factor);
-        }
+  if (free_positions_.empty())
+  {
+    size_ = 1;
+    return;
+  }
 
-        // Add all these appended vectors to my growing vector of vectors.
-        retval.insert(retval.end(), subproblem.begin(), subproblem.end());
-      }
-      else
+  auto num_factors = sorted_factors_.size();
+  num_splits_.assign(free_positions_.size(), std::vector<std::uint64_t>(num_factors, 0));
+
+  for (std::size_t i = 0; i < num_factors; i++)
+  {
+    num_splits_[0][i] = InBounds_(free_positions_[0], sorted_factors_[i]) ? 1 : 0;
+  }
+
+  for (std::size_t s = 1; s < free_positions_.size(); s++)
+  {
+    for (std::size_t i = 0; i < num_factors; i++)
+    {
+      auto residue = sorted_factors_[i];
+      std::uint64_t count = 0;
+      for (std::size_t j = 0; j <= i; j++)
       {
-        // Discard this factor.
+        auto factor = sorted_factors_[j];
+        if (residue % factor == 0 && InBounds_(free_positions_[s], factor))
+        {
+          count += num_splits_[s-1][FactorIndex_(residue / factor)];
+        }
       }
+      num_splits_[s][i] = count;
     }
-    return retval;
   }
+
+  size_ = num_splits_.back()[FactorIndex_(remaining_)];
 }
 
 Factors::Factors() :
-    n_(0)
+    n_(0), remaining_(1), order_(0), size_(0)
 {
 }
 
 Factors::Factors(const unsigned long n, const int order) :
-    n_(n), cofactors_()
+    n_(n)
 {
-  CalculateAllFactors_(n_);
-  cofactors_ = MultiplicativeSplitRecursive_(n, order);
+  Init_(n, order);
 }
 
 Factors::Factors(const unsigned long n, const int order, std::map<unsigned, unsigned long> given) :
-    n_(n), cofactors_()
+    n_(n), given_(given)
 {
   assert(given.size() <= std::size_t(order));
 
-//   // If any of the given factors is not a factor of n, forcibly reset that to
-//   // be a free variable, otherwise accumulate them into a partial product.
-//   unsigned long partial_product = 1;
-//   for (auto f = given.begin(); f != given.end(); f++)
-//   {
-//     auto factor = f->second;
-//     if (n % (factor * partial_product) == 0)
-//     {
-//       partial_product *= factor;
-//     }
-//     else
-//     {
-//       std::cerr << "WARNING: cannot accept " << factor << " as a factor of " << n
-//                 << " with current partial product " << partial_product;
-// #define SET_NONFACTOR_TO_FREE_VARIABLE
-// #ifdef SET_NONFACTOR_TO_FREE_VARIABLE
-//       // Ignore mapping constraint and set the factor to a free variable.
-//       std::cerr << ", ignoring mapping constraint and setting to a free variable."
-//                 << std::endl;
-//       f = given.erase(f);
-// #else       
-//       // Try to find the next *lower* integer that is a factor of n.
-//       // FIXME: there are multiple exceptions that can cause us to be here:
-//       // (a) factor doesn't divide into n.
-//       // (b) factor does divide into n but causes partial product to exceed n.
-//       // (c) factor does divide into n but causes partial product to not
-//       //     divide into n.
-//       // The following code only solves case (a).
-//       std::cerr << "FIXME: please fix this code." << std::endl;
-//       assert(false);
-        
-//       for (; factor >= 1 && (n % factor != 0); factor--);
-//       std::cerr << ", setting this to " << factor << " instead." << std::endl;
-//       f->second = factor;
-//       partial_product *= factor;
-// #endif
-//     }
-//     assert(n % partial_product == 0);
-//   }
-
   unsigned long remaining = n;
   // std::cout << "Given factors: ";
   for (auto f = given.begin(); f != given.end(); f++)
@@ -196,101 +207,82 @@ Factors::Factors(const unsigned long n, const int order, std::map<unsigned, unsi
     }
   }
 
-  CalculateAllFactors_(remaining);
-
-  cofactors_ = MultiplicativeSplitRecursive_(remaining, order - given.size());
+  Init_(remaining, order);
+}
 
-  // Insert the given factors at the specified indices of each of the solutions.
-  for (auto& cofactors : cofactors_)
+void Factors::PruneMax(std::map<unsigned, unsigned long>& max)
+{
+  // Constraints are folded into the split counts instead of filtering a
+  // materialized list, so pruning never touches individual cofactor sets.
+  for (auto& max_factor : max)
   {
-    for (auto& given_factor : given)
+    assert(max_factor.first < unsigned(order_));
+    auto it = max_.find(max_factor.first);
+    if (it == max_.end() || max_factor.second < it->second)
     {
-      // Insert the given factor, pushing all existing factors back.
-      auto index = given_factor.first;
-      auto value = given_factor.second;
-      assert(index <= cofactors.size());
-      cofactors.insert(cofactors.begin() + index, value);
-      // std::cout << "  Inserting given factor " << value << " at index " << index << std::endl;
+      max_[max_factor.first] = max_factor.second;
     }
   }
+  CountSplits_();
 }
 
-void Factors::PruneMax(std::map<unsigned, unsigned long>& max)
+void Factors::PruneMin(std::map<unsigned, unsigned long>& min)
 {
-  // Prune the vector of cofactor sets by removing those sets that have factors
-  // outside user-specified min/max range. We should really have done this during
-  // MultiplicativeSplitRecursive. However, the "given" map complicates things
-  // because given factors may be scattered, and we'll need a map table to
-  // find the original rank from the "compressed" rank seen by
-  // MultiplicativeSplitRecursive. Doing it now is slower but cleaner and less
-  // bug-prone.
-
-  auto cofactors_it = cofactors_.begin();
-  while (cofactors_it != cofactors_.end())
+  for (auto& min_factor : min)
   {
-    bool illegal = false;
-    for (auto& max_factor : max)
+    assert(min_factor.first < unsigned(order_));
+    auto it = min_.find(min_factor.first);
+    if (it == min_.end() || min_factor.second > it->second)
     {
-      auto index = max_factor.first;
-      auto max = max_factor.second;
-      assert(index <= cofactors_it->size());
-      auto value = cofactors_it->at(index);
-      if (value > max)
-      {
-        illegal = true;
-        break;
-      }
+      min_[min_factor.first] = min_factor.second;
     }
-      
-    if (illegal)
-      cofactors_it = cofactors_.erase(cofactors_it);
-    else
-      cofactors_it++;
   }
+  CountSplits_();
 }
 
-void Factors::PruneMin(std::map<unsigned, unsigned long>& min)
+std::vector<unsigned long> Factors::operator[](std::uint64_t index) const
 {
-  // Prune the vector of cofactor sets by removing those sets that have factors
-  // outside user-specified min/max range. We should really have done this during
-  // MultiplicativeSplitRecursive. However, the "given" map complicates things
-  // because given factors may be scattered, and we'll need a map table to
-  // find the original rank from the "compressed" rank seen by
-  // MultiplicativeSplitRecursive. Doing it now is slower but cleaner and less
-  // bug-prone.
+  assert(index < size_);
 
-  auto cofactors_it = cofactors_.begin();
-  while (cofactors_it != cofactors_.end())
+  std::vector<unsigned long> cofactors(order_);
+  for (auto& given_factor : given_)
   {
-    bool illegal = false;
-    for (auto& min_factor : min)
+    cofactors.at(given_factor.first) = given_factor.second;
+  }
+
+  if (free_positions_.empty())
+  {
+    return cofactors;
+  }
+
+  unsigned long residue = remaining_;
+  for (std::size_t s = free_positions_.size() - 1; s > 0; s--)
+  {
+    auto pos = free_positions_[s];
+    for (auto factor : all_factors_)
     {
-      auto index = min_factor.first;
-      auto min = min_factor.second;
-      assert(index <= cofactors_it->size());
-      auto value = cofactors_it->at(index);
-      if (value < min)
+      if (residue % factor != 0 || !InBounds_(pos, factor))
       {
-        illegal = true;
+        continue;
+      }
+      auto count = num_splits_[s-1][FactorIndex_(residue / factor)];
+      if (index < count)
+      {
+        cofactors[pos] = factor;
+        residue /= factor;
         break;
       }
+      index -= count;
     }
-      
-    if (illegal)
-      cofactors_it = cofactors_.erase(cofactors_it);
-    else
-      cofactors_it++;
   }
-}
+  cofactors[free_positions_[0]] = residue;
 
-std::vector<unsigned long>& Factors::operator[](int index)
-{
-  return cofactors_[index];
+  return cofactors;
 }
 
-std::size_t Factors::size()
+std::size_t Factors::size() const
 {
-  return cofactors_.size();
+  return size_;
 }
 
 void Factors::Print()
@@ -326,11 +318,12 @@ void Factors::PrintCoFactors()
 std::ostream& operator<<(std::ostream& out, const Factors& f)
 {
   out << "Co-factors of " << f.n_ << " are: " << std::endl;
-  for (auto cset = f.cofactors_.begin(); cset != f.cofactors_.end(); cset++)
+  for (std::uint64_t index = 0; index < f.size(); index++)
   {
+    auto cset = f[index];
     out << "    " << f.n_ << " = ";
     bool first = true;
-    for (auto i = cset->begin(); i != cset->end(); i++)
+    for (auto i = cset.begin(); i != cset.end(); i++)
     {
       if (first)
       {
@@ -870,6 +863,71 @@ uint128_t RandomGenerator128::Next()
 }
 
 
+namespace
+{
+
+std::uint64_t SplitMix64(std::uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+} // namespace
+
+PermutationGenerator128::PermutationGenerator128(uint128_t bound, std::uint64_t key) :
+    PatternGenerator128(bound),
+    cur_(0)
+{
+  unsigned bits = bound > 1 ? unsigned(msb(uint128_t(bound - 1))) + 1 : 1;
+  half_bits_ = std::max(1U, (bits + 1) / 2);
+  half_mask_ = half_bits_ == 64 ? uint64_max_ : ((std::uint64_t(1) << half_bits_) - 1);
+
+  std::uint64_t state = key;
+  for (auto& round_key : round_keys_)
+  {
+    state = SplitMix64(state);
+    round_key = state;
+  }
+}
+
+uint128_t PermutationGenerator128::Encrypt_(uint128_t x) const
+{
+  std::uint64_t left = std::uint64_t(x >> half_bits_) & half_mask_;
+  std::uint64_t right = std::uint64_t(x & half_mask_);
+  for (auto round_key : round_keys_)
+  {
+    std::uint64_t next_right = left ^ (SplitMix64(right ^ round_key) & half_mask_);
+    left = right;
+    right = next_right;
+  }
+  return (uint128_t(left) << half_bits_) | right;
+}
+
+uint128_t PermutationGenerator128::At(uint128_t index) const
+{
+  assert(index < bound_);
+
+  // The Feistel domain is less than 4x the bound, so this walk is short.
+  uint128_t x = Encrypt_(index);
+  while (x >= bound_)
+  {
+    x = Encrypt_(x);
+  }
+  return x;
+}
+
+uint128_t PermutationGenerator128::Next()
+{
+  if (cur_ >= bound_)
+  {
+    cur_ = 0;
+  }
+  return At(cur_++);
+}
+
+
 //------------------------------------
 //           Miscellaneous
 //------------------------------------
@@ -274,6 +274,12 @@ void OperationSpace::ProjectLowHigh(Shape::DataSpaceID d,
                                     Point& data_space_low,
                                     Point& data_space_high)
 {
+  if (auto kernel = wc->GetProjectionKernel(d))
+  {
+    kernel->ProjectLowHigh(factorized_low, factorized_high, data_space_low, data_space_high);
+    return;
+  }
+
   for (unsigned data_space_dim = 0; data_space_dim < wc->GetShape()->DataSpaceOrder.at(d); data_space_dim++)
   {
     data_space_low[data_space_dim] = 0;
@@ -313,14 +319,18 @@ Point OperationSpace::Project(Shape::DataSpaceID d,
 {
   Point data_space_point(wc->GetShape()->DataSpaceOrder.at(d));
 
+  if (auto kernel = wc->GetProjectionKernel(d))
+  {
+    kernel->Project(factorized_point, data_space_point);
+    return data_space_point;
+  }
+
   for (unsigned data_space_dim = 0; data_space_dim < wc->GetShape()->DataSpaceOrder.at(d); data_space_dim++)
   {
     data_space_point[data_space_dim] = 0;
     for (auto& term : wc->GetShape()->Projections.at(d).at(data_space_dim))
     {
       Coordinate x = factorized_point[term.second];
-      // FIXME: somehow "compile" the coefficients down for a given
-      // workload config so that we avoid the branch and lookup below.
       if (term.first != wc->GetShape()->NumCoefficients)
         data_space_point[data_space_dim] += (x * wc->GetCoefficient(term.first));
       else
@@ -502,6 +512,11 @@ bool OperationSpace::CheckEquality(const OperationSpace& rhs, const int t) const
   return data_spaces_.at(t) == rhs.data_spaces_.at(t);
 }
 
+void OperationSpace::AppendCorners(const int t, std::vector<Coordinate>& corners) const
+{
+  data_spaces_.at(t).AppendCorners(corners);
+}
+
 void OperationSpace::PrintSizes()
 {
   for (unsigned i = 0; i < data_spaces_.size()-1; i++)
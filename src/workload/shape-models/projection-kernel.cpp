@@ -0,0 +1,148 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+
+#include "workload/shape-models/projection-kernel.hpp"
+
+namespace problem
+{
+
+// ======================================== //
+//             ProjectionKernel             //
+// ======================================== //
+
+ProjectionKernel::ProjectionKernel(const Shape& shape, Shape::DataSpaceID d,
+                                   const std::map<Shape::CoefficientID, int>& coefficients)
+{
+  auto& projection = shape.Projections.at(d);
+  rank_ = projection.size();
+  for (auto& expression : projection)
+  {
+    num_terms_ = std::max<unsigned>(num_terms_, expression.size());
+  }
+
+  dims_.assign(rank_ * num_terms_, 0);
+  coefficients_.assign(rank_ * num_terms_, 0);
+  for (unsigned rank = 0; rank < rank_; rank++)
+  {
+    unsigned term_id = rank * num_terms_;
+    for (auto& term : projection.at(rank))
+    {
+      dims_.at(term_id) = term.second;
+      coefficients_.at(term_id) =
+        term.first == shape.NumCoefficients ? 1 : coefficients.at(term.first);
+      term_id++;
+    }
+  }
+
+  // Rank/term counts of the built-in shapes get unrolled kernels; 0 means
+  // the count is read at run time.
+#define PROJECTION_KERNEL_CASE(R, T)                        \
+  if (rank_ == R && num_terms_ == T)                        \
+  {                                                         \
+    project_ = &ProjectImpl<R, T>;                          \
+    project_low_high_ = &ProjectLowHighImpl<R, T>;          \
+    return;                                                 \
+  }
+
+  PROJECTION_KERNEL_CASE(4, 2)  // CNN layer inputs.
+  PROJECTION_KERNEL_CASE(4, 1)  // CNN layer weights and outputs.
+  PROJECTION_KERNEL_CASE(3, 1)
+  PROJECTION_KERNEL_CASE(2, 1)  // GEMM operands.
+  PROJECTION_KERNEL_CASE(1, 1)
+
+#undef PROJECTION_KERNEL_CASE
+
+  project_ = &ProjectImpl<0, 0>;
+  project_low_high_ = &ProjectLowHighImpl<0, 0>;
+}
+
+template <unsigned Rank, unsigned NumTerms>
+void ProjectionKernel::ProjectImpl(const ProjectionKernel& k, const Point& factorized,
+                                   Point& data_space)
+{
+  const unsigned rank = Rank ? Rank : k.rank_;
+  const unsigned num_terms = NumTerms ? NumTerms : k.num_terms_;
+  const auto* dims = k.dims_.data();
+  const auto* coefficients = k.coefficients_.data();
+  const auto* in = factorized.data();
+  auto* out = data_space.data();
+
+  for (unsigned r = 0; r < rank; r++)
+  {
+    Coordinate x = 0;
+    for (unsigned t = 0; t < num_terms; t++)
+    {
+      x += coefficients[r * num_terms + t] * in[dims[r * num_terms + t]];
+    }
+    out[r] = x;
+  }
+}
+
+template <unsigned Rank, unsigned NumTerms>
+void ProjectionKernel::ProjectLowHighImpl(const ProjectionKernel& k,
+                                          const Point& factorized_low,
+                                          const Point& factorized_high,
+                                          Point& data_space_low,
+                                          Point& data_space_high)
+{
+  const unsigned rank = Rank ? Rank : k.rank_;
+  const unsigned num_terms = NumTerms ? NumTerms : k.num_terms_;
+  const auto* dims = k.dims_.data();
+  const auto* coefficients = k.coefficients_.data();
+  const auto* in_low = factorized_low.data();
+  const auto* in_high = factorized_high.data();
+  auto* out_low = data_space_low.data();
+  auto* out_high = data_space_high.data();
+
+  for (unsigned r = 0; r < rank; r++)
+  {
+    Coordinate low = 0;
+    Coordinate high = 0;
+    for (unsigned t = 0; t < num_terms; t++)
+    {
+      // A negative coefficient flips the corners.
+      auto coefficient = coefficients[r * num_terms + t];
+      auto dim = dims[r * num_terms + t];
+      if (coefficient < 0)
+      {
+        low += coefficient * in_high[dim];
+        high += coefficient * in_low[dim];
+      }
+      else
+      {
+        low += coefficient * in_low[dim];
+        high += coefficient * in_high[dim];
+      }
+    }
+    out_low[r] = low;
+    out_high[r] = high;
+  }
+}
+
+} // namespace problem
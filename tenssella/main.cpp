@@ -63,6 +63,8 @@
 
 #include "tutorial/tutorial.hpp"
 
+#include "yaml-spec.hpp"
+
 #define WORKLOAD_GEMM 0
 #define WORKLOAD_CONV 1
 #define WORKLOAD_GEMM_4L 2
@@ -937,13 +939,29 @@ void playground() {
 int main(int argc, char* argv[])
 {
   string test;
-  if (argc == 2)
+  if (argc >= 2)
     test = argv[1];
   else {
     std::cout << "tenssella need an input argument." << std::endl;
     exit(0);
   }
 
+  // Runtime specs: tenssella yaml|yaml-codegen <mapping file or dir> <spec.yaml>...
+  if (test == "yaml" || test == "yaml-codegen") {
+    if (argc < 4) {
+      std::cout << "usage: tenssella " << test
+                << " <mapping file or directory> <arch/problem yaml>..." << std::endl;
+      exit(1);
+    }
+    std::vector<std::string> spec_files(argv + 3, argv + argc);
+    try {
+      return TenssellaBatch(spec_files, argv[2], test == "yaml") == 0 ? 0 : 1;
+    } catch (std::exception& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
   if (test == "regression") {
     //Single Einsum
     test_single_einsum();
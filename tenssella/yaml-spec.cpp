@@ -0,0 +1,703 @@
+/* Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "yaml-spec.hpp"
+#include "tenssella.hpp"
+
+// ----------------------------------------------------------------------------
+// Local helpers.
+// ----------------------------------------------------------------------------
+
+static std::string Lower(std::string s)
+{
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+  return s;
+}
+
+// Spec errors throw rather than exit so that TenssellaBatch can fail a single
+// mapping and carry on with the rest of the batch.
+static void SpecError(const std::string& msg)
+{
+  throw std::runtime_error(msg);
+}
+
+// Resolve a shape name the same way timeloop-model does: an explicit path
+// or <name>.yaml in $TIMELOOP_PROBLEM_SHAPE_DIR or ../problem-shapes.
+static YAML::Node LoadShape(const std::string& shape_name)
+{
+  std::vector<std::string> candidates;
+  if (shape_name.find(".yaml") != std::string::npos || shape_name.find(".yml") != std::string::npos)
+    candidates.push_back(shape_name);
+
+  std::vector<std::string> dirs;
+  if (const char* env = std::getenv("TIMELOOP_PROBLEM_SHAPE_DIR"))
+    dirs.push_back(env);
+  dirs.push_back("../problem-shapes");
+
+  for (auto& dir: dirs)
+    candidates.push_back(dir + "/" + shape_name + ".yaml");
+
+  for (auto& path: candidates)
+  {
+    if (std::filesystem::exists(path))
+    {
+      TRACE(1) << "Reading problem shape from " << path << std::endl;
+      return YAML::LoadFile(path)["shape"];
+    }
+  }
+
+  SpecError("could not locate problem shape " + shape_name);
+  return YAML::Node();
+}
+
+// Nested spacetime tuple from the outermost level num_levels down to (and
+// including) level, e.g., [[SpaceTime_3[0] -> SpaceTime_2[s2,t2]] -> SpaceTime_1[s1,t1]].
+static std::string SpaceTimeChain(unsigned num_levels, unsigned level)
+{
+  std::string chain = "SpaceTime_" + str(num_levels) + "[0]";
+  for (unsigned l = num_levels-1; l >= level && l < num_levels; l--)
+  {
+    std::string tuple = (l == 0) ? "[]" : "[s" + str(l) + ",t" + str(l) + "]";
+    chain = "[" + chain + " -> SpaceTime_" + str(l) + tuple + "]";
+  }
+  return chain;
+}
+
+// Instance coordinates of a unit at a given level: the concatenation of all
+// spacetime coordinates between the outermost level and that level.
+static std::string InstanceCoords(unsigned num_levels, unsigned level)
+{
+  std::vector<std::string> coords;
+  for (unsigned l = num_levels-1; l >= std::max(level, 1u) && l < num_levels; l--)
+  {
+    coords.push_back("s" + str(l));
+    coords.push_back("t" + str(l));
+  }
+  if (coords.empty())
+    coords = { "0", "0" };
+  return sep_list(coords, "[", "]", ",");
+}
+
+// ----------------------------------------------------------------------------
+// Spec loading.
+// ----------------------------------------------------------------------------
+
+YAML::Node LoadYAMLSpecs(const std::vector<std::string>& filenames)
+{
+  YAML::Node merged;
+  for (auto& filename: filenames)
+  {
+    YAML::Node root = YAML::LoadFile(filename);
+    for (auto it = root.begin(); it != root.end(); it++)
+      merged[it->first.as<std::string>()] = it->second;
+  }
+  return merged;
+}
+
+// ----------------------------------------------------------------------------
+// Problem.
+// ----------------------------------------------------------------------------
+
+ProblemShape_YAML::ProblemShape_YAML(isl_ctx* context, YAML::Node problem,
+                                     map<string, DataPtr>& data_map) :
+    ProblemShape(context)
+{
+  YAML::Node shape;
+  if (!problem["shape"])
+    shape = LoadShape("cnn_layer");
+  else if (problem["shape"].IsScalar())
+    shape = LoadShape(problem["shape"].as<std::string>());
+  else
+    shape = problem["shape"];
+
+  YAML::Node instance = problem["instance"] ? problem["instance"] : problem;
+
+  shape_name_ = shape["name"] ? shape["name"].as<std::string>() : "Einsum";
+  // The compute space name doubles as an identifier in generated code.
+  std::replace_if(shape_name_.begin(), shape_name_.end(),
+                  [](unsigned char c) { return !std::isalnum(c); }, '_');
+
+  if (shape["flatten"])
+    SpecError("Tenssella does not support flattened problem dimensions.");
+
+  // Dimensions and bounds. ISL and emitted code use lower-case subscripts.
+  for (auto dim: shape["dimensions"])
+  {
+    std::string name = dim.as<std::string>();
+    if (!instance[name])
+      SpecError("problem instance does not specify a bound for dimension " + name);
+    dimension_names_.push_back(name);
+    bounds_[name] = instance[name].as<int>();
+    iteration_space_dimensions_.push_back(Lower(name));
+    iteration_space_subscripts_.push_back(Lower(name));
+  }
+
+  // Coefficients (defaults overridden by instance values).
+  std::map<std::string, int> coefficients;
+  for (auto coefficient: shape["coefficients"])
+  {
+    std::string name = coefficient["name"].as<std::string>();
+    coefficients[name] = coefficient["default"].as<int>();
+    if (instance[name])
+      coefficients[name] = instance[name].as<int>();
+  }
+
+  // -- Iteration space.
+  std::string tuple = sep_list(iteration_space_dimensions_, "[", "]", ",");
+  std::vector<std::string> ranges;
+  for (auto& dim: dimension_names_)
+    ranges.push_back("0 <= " + Lower(dim) + " < " + str(bounds_.at(dim)));
+  std::string ispace = "{ " + tuple + " : " + sep_list(ranges, "", "", " and ") + " }";
+  TRACE(1) << "Iteration space: " << ispace << std::endl;
+  iteration_space_ = isl_set_read_from_str(context_, ispace.c_str());
+
+  // -- Data spaces. Inputs are listed before the read-write output so that
+  //    the operand order seen by the transform matches the hand-written
+  //    problems (operands..., accumulator).
+  std::vector<std::string> inputs;
+  std::string output;
+
+  for (auto ds: shape["data_spaces"])
+  {
+    std::string ds_name = ds["name"].as<std::string>();
+    bool read_write = ds["read_write"] && ds["read_write"].as<bool>();
+
+    // Each projection entry is one data-space rank: a list of [dim] or
+    // [dim, coefficient] terms (sum-of-products).
+    std::vector<std::string> rank_exprs;
+    for (auto rank: ds["projection"])
+    {
+      std::vector<std::string> terms;
+      if (rank.IsScalar())
+      {
+        terms.push_back(Lower(rank.as<std::string>()));
+      }
+      else
+      {
+        for (auto term: rank)
+        {
+          std::string dim = Lower(term[0].as<std::string>());
+          if (term.size() == 2)
+          {
+            std::string coeff = term[1].as<std::string>();
+            if (coefficients.find(coeff) == coefficients.end())
+              SpecError("unknown coefficient " + coeff + " in projection of " + ds_name);
+            int value = coefficients.at(coeff);
+            terms.push_back(value == 1 ? dim : str(value) + "*" + dim);
+          }
+          else
+          {
+            terms.push_back(dim);
+          }
+        }
+      }
+      rank_exprs.push_back(sep_list(terms, "", "", " + "));
+    }
+
+    DataPtr data_space = make_shared<DataSpace>(ds_name, rank_exprs.size());
+    // We need the following only for generating human-readable emulation code for transfer blocks.
+    for (auto& expr: rank_exprs)
+      data_space->subscripts.push_back(expr);
+
+    std::string projection_str = "{ " + tuple + " -> " + ds_name + sep_list(rank_exprs, "[", "]", ",") + " }";
+    TRACE(1) << "Projection: " << projection_str << std::endl;
+
+    // ---- Limit the tensor accesses to the same domains as iteration space.
+    data_space->read_projection[shape_name_] =
+      isl_map_intersect_domain(isl_map_read_from_str(context_, projection_str.c_str()),
+                               isl_set_copy(iteration_space_));
+    if (read_write)
+    {
+      if (!output.empty())
+        SpecError("Tenssella supports a single read-write data space per Einsum.");
+      data_space->write_projection[shape_name_] =
+        isl_map_intersect_domain(isl_map_read_from_str(context_, projection_str.c_str()),
+                                 isl_set_copy(iteration_space_));
+      data_space->setOutput();
+      output = ds_name;
+    }
+    else
+    {
+      data_space->setInput();
+      inputs.push_back(ds_name);
+    }
+
+    data_map[ds_name] = data_space;
+  }
+
+  if (output.empty())
+    SpecError("problem shape " + shape_name_ + " has no read-write (output) data space.");
+
+  for (auto& ds_name: inputs)
+  {
+    data_spaces_.push_back(ds_name);
+    is_read.insert(ds_name);
+  }
+  data_spaces_.push_back(output);
+  is_read.insert(output);
+  is_write.insert(output);
+
+  // -- Compute space: multiply all inputs and accumulate into the output.
+  ComputeSpace compute;
+  compute.name = shape_name_;
+  compute.num_ranks = dimension_names_.size();
+  compute.subscripts = iteration_space_subscripts_;
+  compute.transform_txt = "    float x = operands.at(" + str(inputs.size()) + ");\n";
+  std::string product;
+  for (unsigned i = 0; i < inputs.size(); i++)
+    product += (i == 0 ? "" : "*") + std::string("operands.at(") + str(i) + ")";
+  if (!product.empty())
+    compute.transform_txt += "    x += " + product + ";\n";
+  compute.transform_txt += "    results.push_back(x);\n";
+  compute_space_ = compute;
+}
+
+// ----------------------------------------------------------------------------
+// Architecture.
+// ----------------------------------------------------------------------------
+
+Arch_YAML::Arch_YAML(isl_ctx* context, YAML::Node arch, ProblemShape_YAML& problem,
+                     map<string, DataPtr>& data_map) :
+    Architecture(arch["storage"].size() + 1, context)
+{
+  if (arch["subtree"] || !arch["storage"] || !arch["arithmetic"])
+    SpecError("Tenssella only accepts flat architecture specs with an arithmetic block and a storage list.");
+
+  std::string cs_name = problem.ComputeSpaceName();
+
+  // Per-level instance counts, innermost storage level first. The
+  // arithmetic level is appended so that fanouts can be computed uniformly.
+  std::vector<int> instances;
+  for (auto level: arch["storage"])
+  {
+    storage_names_.push_back(level["name"].as<std::string>());
+    instances.push_back(level["instances"] ? level["instances"].as<int>() : 1);
+  }
+  auto arithmetic = arch["arithmetic"];
+  arithmetic_name_ = arithmetic["name"] ? arithmetic["name"].as<std::string>() : "MAC";
+  int arithmetic_instances = arithmetic["instances"] ? arithmetic["instances"].as<int>() : 1;
+
+  for (unsigned k = 0; k < storage_names_.size(); k++)
+  {
+    int children = (k == 0) ? arithmetic_instances : instances.at(k-1);
+    if (children % instances.at(k) != 0)
+      SpecError("instances of level " + storage_names_.at(k) + " do not evenly divide its children.");
+    fanouts_.push_back(children / instances.at(k));
+  }
+
+  unsigned N = num_levels_;
+
+  //
+  // The indices appear to be off-by-1 because we wanted to be consistent
+  // with the SpaceTime hierarchy used in the T functions.
+  //
+  for (unsigned k = 0; k < storage_names_.size(); k++)
+  {
+    unsigned hlevel = k + 2;
+    std::string map_str = "{ " + SpaceTimeChain(N, hlevel) + " -> " +
+      storage_names_.at(k) + InstanceCoords(N, hlevel) + " }";
+    TRACE(1) << "Level " << hlevel << ": " << map_str << std::endl;
+    mem_instance_map_[hlevel][storage_names_.at(k)][cs_name] = isl_map_read_from_str(context_, map_str.c_str());
+  }
+
+  // Level 1: synthesized Operand/Result ports, one per data space.
+  for (auto& ds_name: problem.DataSpaceNames())
+  {
+    std::string latch = data_map.at(ds_name)->isOutput() ? ResultLatchName(ds_name) : OperandLatchName(ds_name);
+    std::string map_str = "{ " + SpaceTimeChain(N, 1) + " -> " + latch + InstanceCoords(N, 1) + " }";
+    TRACE(1) << "Level 1: " << map_str << std::endl;
+    mem_instance_map_[1][latch][cs_name] = isl_map_read_from_str(context_, map_str.c_str());
+  }
+
+  // Arithmetic level: connect the Operand ports to the Result ports.
+  std::string map_str = "{ " + SpaceTimeChain(N, 0) + " -> " + arithmetic_name_ + InstanceCoords(N, 0) + " }";
+  TRACE(1) << "Level 0: " << map_str << std::endl;
+  comp_instance_map_[0][cs_name] = isl_map_read_from_str(context_, map_str.c_str());
+}
+
+shared_ptr<Binding> Arch_YAML::CreateBinding(ProblemShape_YAML& problem)
+{
+  //
+  // Every data space is kept at every storage level (Tenssella does not
+  // support bypass). The context id distinguishes the partitions of a
+  // shared storage unit.
+  //
+  shared_ptr<Binding> b = make_shared<Binding>();
+  std::string cs_name = problem.ComputeSpaceName();
+
+  std::size_t context_id = 0;
+  for (auto& ds_name: problem.DataSpaceNames())
+  {
+    for (unsigned k = 0; k < storage_names_.size(); k++)
+      b->memory_binding_[ds_name][k+2][cs_name] = { storage_names_.at(k), context_id };
+
+    std::string latch = problem.WriteDataSpace(ds_name) ? ResultLatchName(ds_name) : OperandLatchName(ds_name);
+    b->memory_binding_[ds_name][1][cs_name] = { latch, 0 };
+    context_id++;
+  }
+
+  b->compute_binding_[cs_name] = { arithmetic_name_, 0 };
+  return b;
+}
+
+// ----------------------------------------------------------------------------
+// Mapping.
+// ----------------------------------------------------------------------------
+
+Mapping_YAML::Mapping_YAML(isl_ctx* context, ProblemShape_YAML& problem, Arch_YAML& arch,
+                           const std::string& filename) :
+    Mapping(context)
+{
+  std::map<unsigned, LevelDirectives> directives;
+
+  auto extension = std::filesystem::path(filename).extension().string();
+  if (extension == ".yaml" || extension == ".yml")
+  {
+    YAML::Node root = YAML::LoadFile(filename);
+    directives = ParseMappingYAML(root["mapping"] ? root["mapping"] : root, arch);
+  }
+  else
+  {
+    directives = ParseMappingText(filename);
+  }
+
+  Generate(directives, problem, arch);
+}
+
+std::map<unsigned, LevelDirectives> Mapping_YAML::ParseMappingYAML(YAML::Node mapping, Arch_YAML& arch)
+{
+  std::map<std::string, unsigned> level_ids;
+  for (unsigned k = 0; k < arch.NumStorageLevels(); k++)
+    level_ids[arch.StorageName(k)] = k;
+
+  std::map<unsigned, LevelDirectives> directives;
+  for (auto directive: mapping)
+  {
+    std::string target = directive["target"].as<std::string>();
+    std::string type = directive["type"].as<std::string>();
+
+    auto it = level_ids.find(target);
+    if (it == level_ids.end())
+      SpecError("mapping targets unknown storage level " + target);
+    auto& level = directives[it->second + 1];
+
+    if (type == "datatype" || type == "bypass")
+    {
+      if (directive["bypass"] && directive["bypass"].size() > 0)
+        SpecError("Tenssella does not support bypass (level " + target + ").");
+      continue;
+    }
+
+    auto factors = ParseFactorLine(directive["factors"] ? directive["factors"].as<std::string>() : "");
+    std::string permutation = directive["permutation"] ? directive["permutation"].as<std::string>() : "";
+
+    if (type == "temporal")
+    {
+      level.temporal_factors = factors;
+      level.temporal_permutation = permutation;
+    }
+    else if (type == "spatial")
+    {
+      level.spatial_factors = factors;
+      level.spatial_permutation = permutation;
+    }
+    else
+    {
+      SpecError("unknown mapping directive type " + type);
+    }
+  }
+  return directives;
+}
+
+// Text format written by Mapping::PrintTenssella(): for each storage level
+// k (outermost first), "t<k>", a factor line and a permutation, optionally
+// followed by "s<k>", a factor line, a permutation and an X/Y split.
+std::map<unsigned, LevelDirectives> Mapping_YAML::ParseMappingText(const std::string& filename)
+{
+  std::map<unsigned, LevelDirectives> directives;
+
+  std::ifstream file(filename);
+  if (!file)
+    SpecError("could not open mapping file " + filename);
+
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty())
+      continue;
+    if (line.at(0) == '#')
+      SpecError("mapping " + filename + ": " + line);
+
+    bool is_spatial;
+    if (line.at(0) == 's')
+      is_spatial = true;
+    else if (line.at(0) == 't')
+      is_spatial = false;
+    else
+      SpecError("malformed mapping line: " + line);
+
+    auto& level = directives[std::stoul(line.substr(1)) + 1];
+
+    std::string factor_line, permutation;
+    if (!std::getline(file, factor_line) || !std::getline(file, permutation))
+      SpecError("truncated mapping file " + filename);
+
+    if (is_spatial)
+    {
+      std::string split;
+      if (!std::getline(file, split))
+        SpecError("truncated mapping file " + filename);
+      level.spatial_factors = ParseFactorLine(factor_line);
+      level.spatial_permutation = permutation;
+    }
+    else
+    {
+      level.temporal_factors = ParseFactorLine(factor_line);
+      level.temporal_permutation = permutation;
+    }
+  }
+  return directives;
+}
+
+void Mapping_YAML::Generate(std::map<unsigned, LevelDirectives>& directives,
+                            ProblemShape_YAML& problem, Arch_YAML& arch)
+{
+  auto& dims = problem.DimensionNames();
+  unsigned num_tile_levels = arch.NumStorageLevels() + 1; // tile levels D..0.
+  unsigned N = arch.NumLevels();
+
+  std::vector<std::vector<int>> bounds;
+  std::map<std::string, int> products;
+  for (auto& dim: dims)
+    products[dim] = 1;
+
+  char buf[256];
+
+  for (unsigned tlevel = num_tile_levels-1; tlevel >= 1 && tlevel < num_tile_levels; tlevel--)
+  {
+    auto& level = directives[tlevel];
+
+    // Fill in unspecified factors and permutation entries.
+    for (auto& dim: dims)
+    {
+      level.temporal_factors.emplace(dim, 1);
+      level.spatial_factors.emplace(dim, 1);
+    }
+
+    int spatial_product = ReduceFactors(level.spatial_factors);
+    if (spatial_product > arch.Fanout(tlevel-1))
+    {
+      sprintf(buf, "spatial factors at level %s (%d) exceed its fanout (%d).",
+              arch.StorageName(tlevel-1).c_str(), spatial_product, arch.Fanout(tlevel-1));
+      SpecError(buf);
+    }
+
+    // Variables: i<dim>_s and i<dim>_t are the spatial and temporal components
+    // of the tile ID for each problem dimension, flattened spatial-major.
+    std::map<std::string, int> factors;
+    std::vector<std::string> tile_vars, exists_vars, constraints;
+    std::vector<int> level_bounds;
+    for (auto& dim: dims)
+    {
+      std::string var = "i" + Lower(dim);
+      int s = level.spatial_factors.at(dim);
+      int t = level.temporal_factors.at(dim);
+      tile_vars.push_back(var);
+      level_bounds.push_back(s * t);
+      products[dim] *= s * t;
+
+      std::vector<std::string> parts;
+      if (s > 1)
+      {
+        factors[var + "_s"] = s;
+        exists_vars.push_back(var + "_s");
+        constraints.push_back("0 <= " + var + "_s < " + str(s));
+        parts.push_back(var + "_s");
+      }
+      if (t > 1)
+      {
+        factors[var + "_t"] = t;
+        exists_vars.push_back(var + "_t");
+        constraints.push_back("0 <= " + var + "_t < " + str(t));
+        parts.push_back(var + "_t");
+      }
+      constraints.push_back(var + " = " + Flatten(parts, factors));
+    }
+    bounds.push_back(level_bounds);
+
+    // Permutations are innermost-first; Flatten() wants big-endian.
+    auto big_endian = [&](const std::string& permutation, const std::string& suffix)
+      {
+        std::vector<std::string> order;
+        for (auto it = permutation.rbegin(); it != permutation.rend(); it++)
+        {
+          std::string var = "i" + Lower(std::string(1, *it)) + suffix;
+          if (factors.find(var) != factors.end())
+            order.push_back(var);
+        }
+        // Dimensions missing from the permutation go outermost.
+        for (auto& dim: dims)
+        {
+          std::string var = "i" + Lower(dim) + suffix;
+          if (factors.find(var) != factors.end() &&
+              std::find(order.begin(), order.end(), var) == order.end())
+            order.insert(order.begin(), var);
+        }
+        return order;
+      };
+
+    constraints.push_back("s = " + Flatten(big_endian(level.spatial_permutation, "_s"), factors));
+    constraints.push_back("t = " + Flatten(big_endian(level.temporal_permutation, "_t"), factors));
+
+    std::string skew = "{ " + sep_list(tile_vars, "[", "]", ",") + " -> SpaceTime_" + str(tlevel) + "[s,t] : ";
+    if (!exists_vars.empty())
+      skew += "exists " + sep_list(exists_vars, "", "", ",") + " : ";
+    skew += sep_list(constraints, "", "", " and ") + " }";
+
+    TRACE(1) << "Skew at tile level " << tlevel << ": " << skew << std::endl;
+    skews_[tlevel] = isl_map_read_from_str(context_, skew.c_str());
+  }
+
+  // The mapping must exactly cover the problem instance.
+  for (auto& dim: dims)
+  {
+    if (products.at(dim) != problem.Bound(dim))
+    {
+      sprintf(buf, "mapping factors for dimension %s multiply to %d, but the problem bound is %d.",
+              dim.c_str(), products.at(dim), problem.Bound(dim));
+      SpecError(buf);
+    }
+  }
+
+  // Innermost (ST0) tile level is always 1.
+  bounds.push_back(std::vector<int>(dims.size(), 1));
+  std::vector<std::vector<int>> strides(bounds.begin()+1, bounds.end());
+  GenerateTileMaps(bounds, strides);
+
+  skews_[N] = isl_map_read_from_str(context_, ("{ [] -> SpaceTime_" + str(N) + "[0] }").c_str());
+
+  std::vector<std::string> zero_vars, zero_constraints;
+  for (auto& dim: dims)
+  {
+    zero_vars.push_back("i" + Lower(dim));
+    zero_constraints.push_back("i" + Lower(dim) + " = 0");
+  }
+  std::string skew0 = "{ " + sep_list(zero_vars, "[", "]", ",") + " -> SpaceTime_0[] : " +
+    sep_list(zero_constraints, "", "", " and ") + " }";
+  skews_[0] = isl_map_read_from_str(context_, skew0.c_str());
+}
+
+// ----------------------------------------------------------------------------
+// Batch driver.
+// ----------------------------------------------------------------------------
+
+int TenssellaBatch(const std::vector<std::string>& spec_files,
+                   const std::string& mapping_path,
+                   bool validate)
+{
+  YAML::Node specs = LoadYAMLSpecs(spec_files);
+  YAML::Node arch_spec = specs["architecture"] ? specs["architecture"] : specs["arch"];
+  if (!specs["problem"] || !arch_spec)
+    SpecError("specs must contain a problem and an arch/architecture.");
+
+  std::vector<std::string> mapping_files;
+  if (std::filesystem::is_directory(mapping_path))
+  {
+    for (auto& entry: std::filesystem::directory_iterator(mapping_path))
+    {
+      auto extension = entry.path().extension().string();
+      if (entry.is_regular_file() && (extension == ".yaml" || extension == ".yml" || extension == ".txt"))
+        mapping_files.push_back(entry.path().string());
+    }
+    std::sort(mapping_files.begin(), mapping_files.end());
+  }
+  else
+  {
+    mapping_files.push_back(mapping_path);
+  }
+
+  // One ISL context for the whole batch. The problem and arch ISL objects
+  // are rebuilt from the loaded specs per mapping because code generation
+  // consumes some of them.
+  isl_ctx* context = isl_ctx_alloc();
+  InitPrinters(context);
+
+  std::vector<std::string> failed;
+  for (auto& mapping_file: mapping_files)
+  {
+    std::string name = "yaml_" + std::filesystem::path(mapping_file).stem().string();
+    std::replace(name.begin(), name.end(), '.', '_');
+
+    std::cout << "Tenssella: " << mapping_file << " -> test_collaterals/" << name << std::endl;
+
+    try
+    {
+      std::map<std::string, ProblemPtr> einsum_map;
+      std::map<std::string, DataPtr> data_space_map;
+      auto problem = make_shared<ProblemShape_YAML>(context, specs["problem"], data_space_map);
+      einsum_map[problem->ComputeSpaceName()] = problem;
+
+      auto arch = make_shared<Arch_YAML>(context, arch_spec, *problem, data_space_map);
+      auto binding = arch->CreateBinding(*problem);
+
+      map<string, MappingPtr> mapping;
+      mapping[problem->ComputeSpaceName()] = make_shared<Mapping_YAML>(context, *problem, *arch, mapping_file);
+
+      TRACE(1) << "Mapping instantiated." << std::endl;
+
+      //Main Codegen Driver Function
+      TenssellaCompile(context, name, einsum_map, data_space_map, mapping, arch, binding);
+    }
+    catch (std::exception& e)
+    {
+      std::cerr << "ERROR: " << mapping_file << ": " << e.what() << std::endl;
+      failed.push_back(mapping_file);
+      continue;
+    }
+
+    if (validate && cmd("bash run_emulator.sh " + name) != 0)
+      failed.push_back(mapping_file);
+  }
+
+  // == Cleanup.
+  UninitPrinters();
+  isl_ctx_free(context);
+
+  std::cout << "Tenssella batch: " << mapping_files.size() << " mapping(s), "
+            << failed.size() << " failed." << std::endl;
+  for (auto& f: failed)
+    std::cout << "  FAILED: " << f << std::endl;
+
+  return failed.size();
+}
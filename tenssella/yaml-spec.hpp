@@ -0,0 +1,132 @@
+/* Copyright (c) 2024, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+
+#include "problem.hpp"
+#include "architecture.hpp"
+#include "mapping.hpp"
+#include "data.hpp"
+
+//
+// Runtime front-end that builds Tenssella's ISL problem, architecture,
+// mapping and binding objects from the same YAML specs consumed by
+// timeloop-model, instead of from baked-in C++ headers.
+//
+// Supported inputs:
+//   problem: a Timeloop problem spec (shape inline or by name, bounds and
+//            coefficients either under "instance" or at the top level).
+//   arch:    a flat (v0.2-style) Timeloop architecture with an
+//            "arithmetic" block and a "storage" list (innermost first).
+//   mapping: a Timeloop mapping YAML (list of temporal/spatial
+//            directives) or the text format emitted by
+//            Mapping::PrintTenssella() (map.tensella.txt).
+//
+// Hardware level numbering follows the hand-written archs: the outermost
+// storage level is level N (= number of storage levels + 1), Timeloop
+// storage level k becomes Tenssella level k+2, level 1 holds synthesized
+// per-data-space operand/result latches and level 0 is the compute unit.
+// Every intermediate SpaceTime_l tuple is [s,t] (linearized spatial and
+// temporal coordinate), SpaceTime_N is [0] and SpaceTime_0 is [].
+//
+
+// Merge the top-level keys of several YAML files into one node (later
+// files override earlier ones), like timeloop-model does for its inputs.
+YAML::Node LoadYAMLSpecs(const std::vector<std::string>& filenames);
+
+// Per-level loop directives extracted from a mapping, indexed by Tenssella
+// tile level (Timeloop storage level k is tile level k+1).
+struct LevelDirectives
+{
+  std::map<std::string, int> temporal_factors;
+  std::string temporal_permutation; // innermost first, like Timeloop.
+  std::map<std::string, int> spatial_factors;
+  std::string spatial_permutation;  // innermost first, like Timeloop.
+};
+
+class ProblemShape_YAML : public ProblemShape
+{
+ protected:
+  std::string shape_name_;
+  std::vector<std::string> dimension_names_;
+  std::map<std::string, int> bounds_;
+
+ public:
+  ProblemShape_YAML(isl_ctx* context, YAML::Node problem,
+                    map<string, DataPtr>& data_map);
+
+  const std::vector<std::string>& DimensionNames() { return dimension_names_; }
+  int Bound(const std::string& dim) { return bounds_.at(dim); }
+};
+
+class Arch_YAML : public Architecture
+{
+ protected:
+  std::vector<std::string> storage_names_; // index = Timeloop storage level.
+  std::vector<int> fanouts_;               // index = Timeloop storage level.
+  std::string arithmetic_name_;
+
+ public:
+  Arch_YAML(isl_ctx* context, YAML::Node arch, ProblemShape_YAML& problem,
+            map<string, DataPtr>& data_map);
+
+  std::size_t NumStorageLevels() { return storage_names_.size(); }
+  const std::string& StorageName(unsigned timeloop_level) { return storage_names_.at(timeloop_level); }
+  int Fanout(unsigned timeloop_level) { return fanouts_.at(timeloop_level); }
+  const std::string& ArithmeticName() { return arithmetic_name_; }
+
+  std::string OperandLatchName(const std::string& ds_name) { return "Operand" + ds_name; }
+  std::string ResultLatchName(const std::string& ds_name) { return "Result" + ds_name; }
+
+  shared_ptr<Binding> CreateBinding(ProblemShape_YAML& problem);
+};
+
+class Mapping_YAML : public Mapping
+{
+ public:
+  Mapping_YAML(isl_ctx* context, ProblemShape_YAML& problem, Arch_YAML& arch,
+               const std::string& filename);
+
+ protected:
+  std::map<unsigned, LevelDirectives> ParseMappingYAML(YAML::Node mapping, Arch_YAML& arch);
+  std::map<unsigned, LevelDirectives> ParseMappingText(const std::string& filename);
+  void Generate(std::map<unsigned, LevelDirectives>& directives,
+                ProblemShape_YAML& problem, Arch_YAML& arch);
+};
+
+// Run Tenssella codegen (and optionally emulator validation) for a single
+// mapping file or every mapping file in a directory, sharing one isl_ctx
+// and one loaded arch/problem YAML spec across the whole batch. A mapping
+// that Tenssella cannot handle is reported as failed without stopping the
+// batch. Returns the number of mappings that failed; errors in the specs
+// themselves throw std::runtime_error.
+int TenssellaBatch(const std::vector<std::string>& spec_files,
+                   const std::string& mapping_path,
+                   bool validate);